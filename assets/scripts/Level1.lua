@@ -1,3 +1,35 @@
+----------------------------------------------------
+-- Behaviour scripts, called once per frame with every entity that uses them
+----------------------------------------------------
+-- Drive back and forth between two x positions
+function tank_patrol(entities, count, delta_time)
+    for i = 1, count do
+        local entity = entities[i]
+        local x, y = get_position(entity)
+        local velocity_x, velocity_y = get_velocity(entity)
+        if (x < 150 and velocity_x < 0) or (x > 300 and velocity_x > 0) then
+            set_velocity(entity, -velocity_x, velocity_y)
+        end
+    end
+end
+
+----------------------------------------------------
+-- Behaviours, coroutines that run from wait to wait
+----------------------------------------------------
+-- Drive for two seconds, stop for one, then turn around
+function tank_sentry(tank)
+    local direction = 1
+    while true do
+        tank:rigidbody().velocity.x = 25 * direction
+        wait(2)
+        tank:rigidbody().velocity.x = 0
+        local x, y = get_position(tank.id)
+        emit_particles("dust", x + 16, y + 30)
+        wait(1)
+        direction = -direction
+    end
+end
+
 -- Define a table with the values of the first level
 Level = {
     ----------------------------------------------------
@@ -21,7 +53,73 @@ Level = {
         texture_asset_id = "tilemap-texture",
         width = 10,
         tile_size = 32,
-        scale = 2.0
+        scale = 2.0,
+        obstacle_tiles = {} -- tile indices that block navigation
+    },
+
+    ----------------------------------------------------
+    -- Render layers, drawn in this order
+    -- Sprites in a y_sort layer are drawn top of the screen first
+    ----------------------------------------------------
+    render_layers = {
+        { name = "tiles" },
+        { name = "ground" },
+        { name = "units", y_sort = true },
+        { name = "air" },
+        { name = "projectiles" },
+        { name = "hud" }
+    },
+
+    ----------------------------------------------------
+    -- Animation clips, shared by every entity that plays them
+    -- A clip is a strip of same sized frames from (x, y) to the right, or a list
+    -- of frames; durations are in milliseconds and a frame can raise an event
+    -- that behaviours wait for with wait_event
+    -- mode is "loop", "ping_pong" or "once"
+    ----------------------------------------------------
+    animations = {
+        { name = "chopper-up",    mode = "loop", strip = { x = 0, y = 0,  width = 32, height = 32, count = 2, duration = 100 } },
+        { name = "chopper-right", mode = "loop", strip = { x = 0, y = 32, width = 32, height = 32, count = 2, duration = 100 } },
+        { name = "chopper-down",  mode = "loop", strip = { x = 0, y = 64, width = 32, height = 32, count = 2, duration = 100 } },
+        { name = "chopper-left",  mode = "loop", strip = { x = 0, y = 96, width = 32, height = 32, count = 2, duration = 100 } }
+    },
+
+    ----------------------------------------------------
+    -- Particle emitters, used by particles components and emit_particles
+    -- lifetime (seconds), speed (pixels per second) and angle (degrees clockwise
+    -- from the x axis) are picked between min and max for every particle; size
+    -- and color are curves over the particle's life, from time 0 to 1
+    ----------------------------------------------------
+    particle_emitters = {
+        {
+            name = "exhaust",
+            texture_asset_id = "bullet-texture",
+            layer = "ground",
+            lifetime = { min = 0.4, max = 0.7 },
+            speed = { min = 4, max = 12 },
+            angle = { min = 0, max = 360 },
+            rate = 25, -- particles per second
+            size = { { time = 0, value = 2 }, { time = 1, value = 6 } },
+            color = {
+                { time = 0, r = 210, g = 210, b = 210, a = 160 },
+                { time = 1, r = 90, g = 90, b = 90, a = 0 }
+            }
+        },
+        {
+            name = "dust",
+            texture_asset_id = "bullet-texture",
+            layer = "ground",
+            lifetime = { min = 0.3, max = 0.9 },
+            speed = { min = 10, max = 40 },
+            angle = { min = 180, max = 360 },
+            acceleration = { x = 0, y = 30 },
+            count = 40, -- particles per burst
+            size = { { time = 0, value = 3 }, { time = 0.5, value = 5 }, { time = 1, value = 1 } },
+            color = {
+                { time = 0, r = 170, g = 140, b = 90, a = 220 },
+                { time = 1, r = 120, g = 100, b = 70, a = 0 }
+            }
+        }
     },
 
     ----------------------------------------------------
@@ -45,14 +143,15 @@ Level = {
                     texture_asset_id = "chopper-texture",
                     width = 32,
                     height = 32,
-                    z_index = 4,
+                    layer = "air",
                     fixed = false,
                     src_rect_x = 0,
                     src_rect_y = 0
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "chopper-up",
+                    -- played by the keyboard controller when turning
+                    facing = { up = "chopper-up", right = "chopper-right", down = "chopper-down", left = "chopper-left" }
                 },
                 boxcollider = {
                     width = 32,
@@ -70,10 +169,15 @@ Level = {
                     hit_percentage_damage = 10,
                     projectile_damage_layer = 1,
                     is_auto = false,
+                    pool_size = 8, -- projectiles kept for reuse
                 },
                 keyboard_controller = {
                     speed = 50,
                 },
+                particles = {
+                    emitter = "exhaust",
+                    offset = { x = 16, y = 24 }
+                },
                 camera_follow = {
                     follow = true
                 }
@@ -88,11 +192,18 @@ Level = {
                     scale = { x = 1.0, y = 1.0 },
                     rotation = 0.0, -- degrees
                 },
+                rigidbody = {
+                    velocity = { x = 20.0, y = 0.0 }
+                },
+                script = {
+                    on_update = tank_patrol,
+                    name = "tank_patrol"
+                },
                 sprite = {
                     texture_asset_id = "tank-texture",
                     width = 32,
                     height = 32,
-                    z_index = 2
+                    layer = "units"
                 },
                 boxcollider = {
                     width = 25,
@@ -111,6 +222,38 @@ Level = {
                     projectile_damage_layer = 2,
                 }
             }
+        },
+        {
+            -- Tank
+            group = "enemies",
+            components = {
+                transform = {
+                    position = { x = 450, y = 497 },
+                    scale = { x = 1.0, y = 1.0 },
+                    rotation = 0.0, -- degrees
+                },
+                rigidbody = {
+                    velocity = { x = 0.0, y = 0.0 }
+                },
+                behaviour = {
+                    run = tank_sentry
+                },
+                sprite = {
+                    texture_asset_id = "tank-texture",
+                    width = 32,
+                    height = 32,
+                    layer = "units"
+                },
+                boxcollider = {
+                    width = 25,
+                    height = 18,
+                    damage_layer = 2,
+                    offset = { x = 0, y = 7 }
+                },
+                health = {
+                    health_percentage = 100
+                }
+            }
         }
     }
 }
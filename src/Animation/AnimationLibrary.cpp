@@ -0,0 +1,89 @@
+#include <algorithm>
+#include "../Logger/Logger.h"
+#include "./AnimationLibrary.h"
+
+// FNV-1a of the mode and every field of the frames
+static uint64_t HashClip(AnimationMode mode, const std::vector<AnimationFrame>& clipFrames) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 0x100000001b3ull;
+    };
+    mix(static_cast<uint64_t>(mode));
+    for (auto& frame: clipFrames) {
+        mix((uint64_t(uint32_t(frame.rect.x)) << 32) | uint32_t(frame.rect.y));
+        mix((uint64_t(uint32_t(frame.rect.w)) << 32) | uint32_t(frame.rect.h));
+        mix((uint64_t(frame.duration) << 16) | frame.event);
+    }
+    return hash;
+}
+
+static bool IsSameFrame(const AnimationFrame& a, const AnimationFrame& b) {
+    return a.rect.x == b.rect.x && a.rect.y == b.rect.y && a.rect.w == b.rect.w && a.rect.h == b.rect.h &&
+        a.duration == b.duration && a.event == b.event;
+}
+
+uint16_t AnimationLibrary::AddClip(const std::string& name, AnimationMode mode, std::vector<AnimationFrame> clipFrames) {
+    if (clipFrames.empty()) {
+        Logger::Warn("Animation clip {} has no frames", name);
+        return NO_ANIMATION_CLIP;
+    }
+    for (auto& frame: clipFrames) frame.duration = std::max<uint16_t>(frame.duration, 1);
+
+    uint64_t hash = HashClip(mode, clipFrames);
+    uint16_t clipId = NO_ANIMATION_CLIP;
+    auto candidates = clipsByHash.equal_range(hash);
+    for (auto candidate = candidates.first; candidate != candidates.second && clipId == NO_ANIMATION_CLIP; candidate++) {
+        const AnimationClip& clip = clips[candidate -> second];
+        if (clip.mode != mode || clip.numFrames != clipFrames.size()) continue;
+        bool isSame = true;
+        for (size_t i = 0; i < clipFrames.size() && isSame; i++) isSame = IsSameFrame(frames[clip.firstFrame + i], clipFrames[i]);
+        if (isSame) clipId = candidate -> second;
+    }
+
+    if (clipId == NO_ANIMATION_CLIP) {
+        if (clips.size() >= NO_ANIMATION_CLIP || clipFrames.size() > UINT16_MAX) {
+            Logger::Err("Too many animation clips or frames, dropping clip {}", name);
+            return NO_ANIMATION_CLIP;
+        }
+        uint32_t duration = 0;
+        for (auto& frame: clipFrames) duration += frame.duration;
+        clipId = clips.size();
+        clips.push_back({static_cast<uint32_t>(frames.size()), static_cast<uint16_t>(clipFrames.size()), mode, duration});
+        frames.insert(frames.end(), clipFrames.begin(), clipFrames.end());
+        clipsByHash.emplace(hash, clipId);
+    }
+    if (!name.empty()) clipIds[name] = clipId;
+    return clipId;
+}
+
+uint16_t AnimationLibrary::AddStrip(const std::string& name, AnimationMode mode, SDL_Rect firstRect, int count, int duration) {
+    std::vector<AnimationFrame> clipFrames;
+    uint16_t frameDuration = std::clamp(duration, 1, UINT16_MAX);
+    for (int i = 0; i < count; i++) {
+        clipFrames.push_back({{firstRect.x + i * firstRect.w, firstRect.y, firstRect.w, firstRect.h}, frameDuration, NO_ANIMATION_EVENT});
+    }
+    return AddClip(name, mode, std::move(clipFrames));
+}
+
+uint16_t AnimationLibrary::GetClipId(const std::string& name) const {
+    auto clipId = clipIds.find(name);
+    return clipId != clipIds.end() ? clipId -> second : NO_ANIMATION_CLIP;
+}
+
+uint16_t AnimationLibrary::GetEventId(const std::string& name) {
+    auto eventId = eventIds.find(name);
+    if (eventId != eventIds.end()) return eventId -> second;
+    eventIds.emplace(name, eventNames.size());
+    eventNames.push_back(name);
+    return eventNames.size() - 1;
+}
+
+void AnimationLibrary::Clear() {
+    frames.clear();
+    clips.clear();
+    clipIds.clear();
+    clipsByHash.clear();
+    eventNames.clear();
+    eventIds.clear();
+}
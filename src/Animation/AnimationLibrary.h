@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <SDL2/SDL.h>
+
+// Clip id of "no clip"
+const uint16_t NO_ANIMATION_CLIP = 0xFFFF;
+// Event id of a frame without an event
+const uint16_t NO_ANIMATION_EVENT = 0xFFFF;
+
+enum class AnimationMode: uint8_t {
+    LOOP,
+    // Forward, then back to the first frame, without showing the end frames twice
+    PING_PONG,
+    // Stops on the last frame
+    ONCE
+};
+
+struct AnimationFrame {
+    // Relative to the sprite's texture
+    SDL_Rect rect;
+    uint16_t duration;
+    // Raised when the frame is entered
+    uint16_t event;
+};
+
+// A run of frames in the library's frame table
+struct AnimationClip {
+    uint32_t firstFrame;
+    uint16_t numFrames;
+    AnimationMode mode;
+    // Of one pass over the frames, in milliseconds
+    uint32_t duration;
+};
+
+// Animation clips by name, with the frames of every clip in one table
+// Clips with the same frames and mode are only stored once, whatever they are called, so
+// thousands of entities playing them all read the same few frames.
+class AnimationLibrary {
+    private:
+        std::vector<AnimationFrame> frames;
+        std::vector<AnimationClip> clips;
+        std::unordered_map<std::string, uint16_t> clipIds;
+        // Clips by a hash of their frames and mode, to find duplicates
+        std::unordered_multimap<uint64_t, uint16_t> clipsByHash;
+        std::vector<std::string> eventNames;
+        std::unordered_map<std::string, uint16_t> eventIds;
+
+    public:
+        // Add a clip, or give another name to an identical one; NO_ANIMATION_CLIP if it has no frames
+        // Frame durations are in milliseconds and at least 1.
+        uint16_t AddClip(const std::string& name, AnimationMode mode, std::vector<AnimationFrame> clipFrames);
+        // Clip of count frames of one size laid out left to right from (x, y)
+        uint16_t AddStrip(const std::string& name, AnimationMode mode, SDL_Rect firstRect, int count, int duration);
+
+        // NO_ANIMATION_CLIP if there is no such clip
+        uint16_t GetClipId(const std::string& name) const;
+        const AnimationClip& GetClip(uint16_t clipId) const { return clips[clipId]; }
+        const AnimationFrame& GetFrame(const AnimationClip& clip, int frame) const { return frames[clip.firstFrame + frame]; }
+        bool IsValid(uint16_t clipId) const { return clipId < clips.size(); }
+
+        uint16_t GetEventId(const std::string& name);
+        const std::string& GetEventName(uint16_t eventId) const { return eventNames[eventId]; }
+
+        int GetNumClips() const { return clips.size(); }
+        int GetNumFrames() const { return frames.size(); }
+        void Clear();
+};
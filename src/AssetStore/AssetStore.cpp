@@ -15,12 +15,24 @@ AssetStore::~AssetStore() {
 }
 
 void AssetStore::SetRenderer(SDL_Renderer* renderer){
+    // Text textures belong to the previous renderer
+    glyphAtlases.clear();
+    textCache.Clear();
     this -> renderer = renderer;
 }
 
 void AssetStore::ClearAssets() {
-    for(auto texture: textures) {
-        SDL_DestroyTexture(texture.second);
+    // Before the fonts they were rendered from
+    glyphAtlases.clear();
+    textCache.Clear();
+    pendingTextures.Clear();
+    for (auto page: atlasPages) {
+        if (page) SDL_DestroyTexture(page);
+    }
+    atlasPages.clear();
+    for (auto& page: shippedAtlasPages) {
+        if (page) SDL_DestroyTexture(page);
+        page = nullptr;
     }
     textures.clear();
  
@@ -30,23 +42,102 @@ void AssetStore::ClearAssets() {
     fonts.clear();
 }
 
+bool AssetStore::FindShippedTexture(const string& filePath, TextureRegion& region) {
+    if (!isShippedAtlasLoaded) {
+        isShippedAtlasLoaded = true;
+        if (shippedAtlas.Load(ATLAS_DIRECTORY + "/" + ATLAS_INDEX_FILE)) {
+            Logger::Log("Using the texture atlas in {}, {} pages", ATLAS_DIRECTORY, shippedAtlas.pageFiles.size());
+        }
+        shippedAtlasPages.assign(shippedAtlas.pageFiles.size(), nullptr);
+    }
+    const AtlasIndexEntry* entry = shippedAtlas.Find(filePath);
+    if (!entry) return false;
+
+    SDL_Texture*& page = shippedAtlasPages[entry -> page];
+    if (!page) {
+        string pagePath = ATLAS_DIRECTORY + "/" + shippedAtlas.pageFiles[entry -> page];
+        SDL_Surface* surface = IMG_Load(pagePath.c_str());
+        if (!surface) {
+            Logger::Err("Could not load the atlas page " + pagePath);
+            return false;
+        }
+        page = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_FreeSurface(surface);
+        if (!page) return false;
+    }
+    region = {page, entry -> rect};
+    return true;
+}
+
 void AssetStore::AddTexture(const string& assetId, const string& filePath){
-    SDL_Surface* surface = IMG_Load(filePath.c_str());
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+    // Without a renderer (headless simulation) there is nothing to upload the image to
+    if (!renderer) return;
 
-    // Add texture to map
-    textures.emplace(assetId, texture);
+    TextureRegion region;
+    if (FindShippedTexture(filePath, region)) {
+        textures.emplace(assetId, region);
+        return;
+    }
+    AddTexture(assetId, IMG_Load(filePath.c_str()));
+}
+
+void AssetStore::AddTexture(const string& assetId, SDL_Surface* surface, const string& filePath){
+    if (!renderer || !surface) {
+        if (surface) SDL_FreeSurface(surface);
+        return;
+    }
+    TextureRegion region;
+    if (!filePath.empty() && FindShippedTexture(filePath, region)) {
+        SDL_FreeSurface(surface);
+        textures.emplace(assetId, region);
+        return;
+    }
+    pendingTextures.Add(assetId, surface);
 }
 
-SDL_Texture* AssetStore::GetTexture(const string& assetId) {
+void AssetStore::PackTextures() {
+    if (pendingTextures.IsEmpty()) return;
+    vector<SDL_Surface*> pages = pendingTextures.Build();
+    int firstPage = atlasPages.size();
+    for (auto surface: pages) {
+        atlasPages.push_back(surface ? SDL_CreateTextureFromSurface(renderer, surface) : nullptr);
+        if (surface) SDL_FreeSurface(surface);
+    }
+    for (auto& image: pendingTextures.GetImages()) {
+        textures.emplace(image.name, TextureRegion{atlasPages[firstPage + image.page], image.rect});
+    }
+    Logger::Log("Packed {} textures into {} atlas pages", pendingTextures.GetImages().size(), pages.size());
+    pendingTextures.Clear();
+}
+
+const TextureRegion& AssetStore::GetTexture(const string& assetId) {
+    if (!pendingTextures.IsEmpty()) PackTextures();
     return textures[assetId];
 }
 
 void AssetStore::AddFont(const string& assetId, const string& filePath, int fontSize) {
+    if (!TTF_WasInit()) return;
     fonts.emplace(assetId, TTF_OpenFont(filePath.c_str(), fontSize));
 }
 
 TTF_Font* AssetStore::GetFont(const string& assetId) {
    return fonts[assetId]; 
 }
+
+GlyphAtlas* AssetStore::GetGlyphAtlas(const string& fontId) {
+    if (!renderer) return nullptr;
+    auto found = glyphAtlases.find(fontId);
+    if (found != glyphAtlases.end()) return found -> second.get();
+
+    auto glyphAtlas = make_unique<GlyphAtlas>();
+    if (!glyphAtlas -> Build(renderer, GetFont(fontId))) {
+        Logger::Warn("Could not build the glyph atlas of font {}", fontId);
+        glyphAtlas.reset();
+    }
+    return glyphAtlases.emplace(fontId, std::move(glyphAtlas)).first -> second.get();
+}
+
+const CachedText* AssetStore::GetText(const string& fontId, string_view text, SDL_Color color) {
+    if (!renderer) return nullptr;
+    return textCache.Get(renderer, GetFont(fontId), text, color);
+}
@@ -1,17 +1,38 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
+#include <string_view>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#include "../Renderer/GlyphAtlas.h"
+#include "../Renderer/TextCache.h"
+#include "./TextureAtlas.h"
 
 using namespace std;
 
 class AssetStore{
     private:
         SDL_Renderer* renderer;
-        map<string, SDL_Texture*> textures;
+        // Every texture asset is a region of an atlas page
+        map<string, TextureRegion> textures;
+        // Pages packed at load time, destroyed with the assets
+        vector<SDL_Texture*> atlasPages;
+        // Images added since the last packing, packed the first time a texture is asked for
+        TextureAtlasBuilder pendingTextures;
+        // The atlas written by the packer target, its pages are loaded when first used
+        AtlasIndex shippedAtlas;
+        vector<SDL_Texture*> shippedAtlasPages;
+        bool isShippedAtlasLoaded = false;
         map<string, TTF_Font*> fonts;
+        // Built the first time a font is drawn with, nullptr if that failed
+        map<string, unique_ptr<GlyphAtlas>> glyphAtlases;
+        TextCache textCache;
+
+        // Region of the image in the shipped atlas, false if it isn't there or is out of date
+        bool FindShippedTexture(const string& filePath, TextureRegion& region);
         // TODO: create a map for audio 
 
     public:
@@ -20,8 +41,20 @@ class AssetStore{
         void SetRenderer(SDL_Renderer* renderer);
         void ClearAssets();
         void AddTexture(const string& assetId, const string& filePath);
-        SDL_Texture* GetTexture(const string& assetId);
+        // Add an already decoded image to the atlas, the surface is freed
+        // With the file path, the shipped atlas is used when it holds that image.
+        void AddTexture(const string& assetId, SDL_Surface* surface, const string& filePath = "");
+        // Pack the images added since the last call into new atlas pages
+        void PackTextures();
+        // The atlas page of the texture and where the texture is in it, srcRects are relative to rect
+        const TextureRegion& GetTexture(const string& assetId);
         
         void AddFont(const string& assetId, const string& filePath, int fontSize);
         TTF_Font* GetFont(const string& assetId);
+        // Glyphs of a font for text that changes often, nullptr without a renderer
+        GlyphAtlas* GetGlyphAtlas(const string& fontId);
+        // A string rendered once and cached, for text that rarely changes
+        const CachedText* GetText(const string& fontId, string_view text, SDL_Color color);
+        // Frees the text textures evicted while the previous texts were waiting to be drawn, appending them to destroyed
+        void BeginTextFrame(vector<SDL_Texture*>& destroyed) { textCache.BeginFrame(destroyed); }
 };
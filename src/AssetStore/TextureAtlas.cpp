@@ -0,0 +1,236 @@
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <numeric>
+#include <algorithm>
+#include <filesystem>
+#include "../Logger/Logger.h"
+#include "./TextureAtlas.h"
+
+SkylinePacker::SkylinePacker(int width, int height) {
+    this -> width = width;
+    this -> height = height;
+    skyline.push_back({0, 0, width});
+}
+
+int SkylinePacker::Fit(int i, int w, int h) const {
+    int x = skyline[i].x;
+    if (x + w > width) return -1;
+    int y = skyline[i].y;
+    int widthLeft = w;
+    for (int j = i; widthLeft > 0; j++) {
+        y = std::max(y, skyline[j].y);
+        if (y + h > height) return -1;
+        widthLeft -= skyline[j].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::Insert(int w, int h, SDL_Point& position) {
+    // Lowest top edge wins, then the narrowest node so wide gaps are left for wide images
+    int bestIndex = -1;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    for (int i = 0; i < static_cast<int>(skyline.size()); i++) {
+        int y = Fit(i, w, h);
+        if (y < 0) continue;
+        if (y + h < bestTop || (y + h == bestTop && skyline[i].width < bestWidth)) {
+            bestIndex = i;
+            bestTop = y + h;
+            bestWidth = skyline[i].width;
+            position = {skyline[i].x, y};
+        }
+    }
+    if (bestIndex < 0) return false;
+
+    // Raise the skyline under the rectangle, trimming or removing the nodes it covers
+    skyline.insert(skyline.begin() + bestIndex, {position.x, position.y + h, w});
+    for (int i = bestIndex + 1; i < static_cast<int>(skyline.size());) {
+        int previousEnd = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= previousEnd) break;
+        int overlap = previousEnd - skyline[i].x;
+        if (skyline[i].width <= overlap) {
+            skyline.erase(skyline.begin() + i);
+            continue;
+        }
+        skyline[i].x += overlap;
+        skyline[i].width -= overlap;
+        break;
+    }
+    for (int i = 0; i + 1 < static_cast<int>(skyline.size());) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+    return true;
+}
+
+int SkylinePacker::GetUsedHeight() const {
+    int usedHeight = 0;
+    for (auto& node: skyline) usedHeight = std::max(usedHeight, node.y);
+    return usedHeight;
+}
+
+TextureAtlasBuilder::~TextureAtlasBuilder() {
+    Clear();
+}
+
+void TextureAtlasBuilder::Add(const std::string& name, SDL_Surface* surface) {
+    if (!surface) return;
+    // One pixel layout for the copy into the page
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(surface);
+    if (!converted) {
+        Logger::Err("Could not convert image {} for the atlas: {}", name, SDL_GetError());
+        return;
+    }
+    if (converted -> w == 0 || converted -> h == 0) {
+        SDL_FreeSurface(converted);
+        return;
+    }
+    images.push_back({name, converted, -1, {0, 0, converted -> w, converted -> h}});
+}
+
+// Copy the image with its edge pixels repeated into the padding around it
+static void CopyExtruded(SDL_Surface* page, const AtlasImage& image) {
+    SDL_Surface* source = image.surface;
+    SDL_LockSurface(source);
+    SDL_LockSurface(page);
+    for (int y = -ATLAS_PADDING; y < image.rect.h + ATLAS_PADDING; y++) {
+        int pageY = image.rect.y + y;
+        if (pageY < 0 || pageY >= page -> h) continue;
+        int sourceY = std::clamp(y, 0, image.rect.h - 1);
+        auto sourceRow = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(source -> pixels) + sourceY * source -> pitch);
+        auto pageRow = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(page -> pixels) + pageY * page -> pitch);
+        for (int x = -ATLAS_PADDING; x < image.rect.w + ATLAS_PADDING; x++) {
+            int pageX = image.rect.x + x;
+            if (pageX < 0 || pageX >= page -> w) continue;
+            pageRow[pageX] = sourceRow[std::clamp(x, 0, image.rect.w - 1)];
+        }
+    }
+    SDL_UnlockSurface(page);
+    SDL_UnlockSurface(source);
+}
+
+std::vector<SDL_Surface*> TextureAtlasBuilder::Build() {
+    std::vector<int> order(images.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return images[a].rect.h > images[b].rect.h;
+    });
+
+    std::vector<SkylinePacker> packers;
+    std::vector<SDL_Point> pageSizes;
+    for (int index: order) {
+        AtlasImage& image = images[index];
+        int paddedWidth = image.rect.w + 2 * ATLAS_PADDING;
+        int paddedHeight = image.rect.h + 2 * ATLAS_PADDING;
+        SDL_Point position = {0, 0};
+        image.page = -1;
+        if (paddedWidth > ATLAS_PAGE_SIZE || paddedHeight > ATLAS_PAGE_SIZE) {
+            packers.emplace_back(paddedWidth, paddedHeight);
+            pageSizes.push_back({paddedWidth, paddedHeight});
+            image.page = packers.size() - 1;
+        } else {
+            for (int page = 0; page < static_cast<int>(packers.size()) && image.page < 0; page++) {
+                if (packers[page].Insert(paddedWidth, paddedHeight, position)) image.page = page;
+            }
+            if (image.page < 0) {
+                packers.emplace_back(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+                pageSizes.push_back({ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE});
+                packers.back().Insert(paddedWidth, paddedHeight, position);
+                image.page = packers.size() - 1;
+            }
+        }
+        image.rect.x = position.x + ATLAS_PADDING;
+        image.rect.y = position.y + ATLAS_PADDING;
+    }
+
+    // Pages are only as tall as what was packed into them
+    std::vector<SDL_Surface*> pages;
+    for (int page = 0; page < static_cast<int>(packers.size()); page++) {
+        int pageHeight = std::max(packers[page].GetUsedHeight(), 1);
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, pageSizes[page].x, pageHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!surface) Logger::Err("Could not create an atlas page: {}", SDL_GetError());
+        pages.push_back(surface);
+    }
+    for (auto& image: images) {
+        if (pages[image.page]) CopyExtruded(pages[image.page], image);
+    }
+    return pages;
+}
+
+void TextureAtlasBuilder::Clear() {
+    for (auto& image: images) SDL_FreeSurface(image.surface);
+    images.clear();
+}
+
+bool AtlasIndex::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) return false;
+    pageFiles.clear();
+    entries.clear();
+
+    // "page FILE" and "image PATH PAGE X Y W H SIZE TIME" lines
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string kind;
+        stream >> kind;
+        if (kind == "page") {
+            std::string pageFile;
+            stream >> pageFile;
+            pageFiles.push_back(pageFile);
+        } else if (kind == "image") {
+            std::string imagePath;
+            AtlasIndexEntry entry;
+            stream >> imagePath >> entry.page >> entry.rect.x >> entry.rect.y >> entry.rect.w >> entry.rect.h >> entry.fileSize >> entry.modifiedTime;
+            if (!stream || entry.page < 0) {
+                Logger::Warn("Bad line in the atlas index {}: {}", path, line);
+                continue;
+            }
+            entries[NormalizePath(imagePath)] = entry;
+        }
+    }
+    return true;
+}
+
+bool AtlasIndex::Save(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+    for (auto& pageFile: pageFiles) file << "page " << pageFile << "\n";
+    for (auto& [imagePath, entry]: entries) {
+        file << "image " << imagePath << " " << entry.page << " " << entry.rect.x << " " << entry.rect.y << " " << entry.rect.w << " " << entry.rect.h << " " << entry.fileSize << " " << entry.modifiedTime << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+const AtlasIndexEntry* AtlasIndex::Find(const std::string& imagePath) const {
+    auto found = entries.find(NormalizePath(imagePath));
+    if (found == entries.end() || found -> second.page >= static_cast<int>(pageFiles.size())) return nullptr;
+    uintmax_t fileSize;
+    int64_t modifiedTime;
+    if (!GetFileStamp(imagePath, fileSize, modifiedTime) || fileSize != found -> second.fileSize || modifiedTime != found -> second.modifiedTime) {
+        Logger::Warn("Atlas entry of {} is stale, packing it at load time", imagePath);
+        return nullptr;
+    }
+    return &found -> second;
+}
+
+std::string AtlasIndex::NormalizePath(const std::string& path) {
+    return std::filesystem::path(path).lexically_normal().generic_string();
+}
+
+bool AtlasIndex::GetFileStamp(const std::string& path, uintmax_t& fileSize, int64_t& modifiedTime) {
+    std::error_code error;
+    fileSize = std::filesystem::file_size(path, error);
+    if (error) return false;
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    if (error) return false;
+    modifiedTime = writeTime.time_since_epoch().count();
+    return true;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <SDL2/SDL.h>
+
+const int ATLAS_PAGE_SIZE = 2048;
+// Transparent gap around every image is filled by repeating its edge pixels, so filtering
+// and rounding at the edge of a sprite never pick up its neighbour
+const int ATLAS_PADDING = 2;
+// Written by the atlas packer target, used instead of packing at load time when it is up to date
+const std::string ATLAS_DIRECTORY = "./assets/atlas";
+const std::string ATLAS_INDEX_FILE = "atlas.txt";
+
+// Where an image ended up: a page texture and its rectangle in it
+struct TextureRegion {
+    SDL_Texture* texture = nullptr;
+    SDL_Rect rect = {0, 0, 0, 0};
+};
+
+struct SkylineNode {
+    int x;
+    int y;
+    int width;
+};
+
+// Bottom-left skyline rectangle packer for one page
+class SkylinePacker {
+    private:
+        int width;
+        int height;
+        std::vector<SkylineNode> skyline;
+
+        // Top of a w x h rectangle placed at node i, -1 if it doesn't fit there
+        int Fit(int i, int w, int h) const;
+
+    public:
+        SkylinePacker(int width, int height);
+
+        bool Insert(int w, int h, SDL_Point& position);
+        // Lowest height that holds everything inserted so far
+        int GetUsedHeight() const;
+};
+
+struct AtlasImage {
+    std::string name;
+    SDL_Surface* surface;
+    int page;
+    // Without the padding
+    SDL_Rect rect;
+};
+
+// Packs surfaces into as few pages as it can, tallest first
+// Images bigger than a page get a page of their own.
+class TextureAtlasBuilder {
+    private:
+        std::vector<AtlasImage> images;
+
+    public:
+        TextureAtlasBuilder() = default;
+        TextureAtlasBuilder(const TextureAtlasBuilder&) = delete;
+        TextureAtlasBuilder& operator=(const TextureAtlasBuilder&) = delete;
+        ~TextureAtlasBuilder();
+
+        // Takes ownership of the surface
+        void Add(const std::string& name, SDL_Surface* surface);
+        // Place every image and copy it into the returned page surfaces, which the caller frees
+        std::vector<SDL_Surface*> Build();
+
+        const std::vector<AtlasImage>& GetImages() const { return images; }
+        bool IsEmpty() const { return images.empty(); }
+        // Free the added surfaces
+        void Clear();
+};
+
+struct AtlasIndexEntry {
+    int page;
+    SDL_Rect rect;
+    // Of the source image when it was packed, a mismatch means the atlas is stale
+    uintmax_t fileSize;
+    int64_t modifiedTime;
+};
+
+// Pages and image rectangles of a packed atlas, by source image path
+struct AtlasIndex {
+    std::vector<std::string> pageFiles;
+    std::map<std::string, AtlasIndexEntry> entries;
+
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+    // The entry of the image, nullptr if it isn't there or the file changed since
+    const AtlasIndexEntry* Find(const std::string& imagePath) const;
+
+    static std::string NormalizePath(const std::string& path);
+    static bool GetFileStamp(const std::string& path, uintmax_t& fileSize, int64_t& modifiedTime);
+};
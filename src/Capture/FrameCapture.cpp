@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <filesystem>
+#include <SDL2/SDL_image.h>
+#include "./FrameCapture.h"
+#include "./QoiEncoder.h"
+#include "../Logger/Logger.h"
+
+FrameCapture::FrameCapture(CaptureFormat format, CaptureDropPolicy dropPolicy) {
+    this -> format = format;
+    this -> dropPolicy = dropPolicy;
+}
+
+FrameCapture::~FrameCapture() {
+    Stop();
+}
+
+CaptureFormat FrameCapture::ParseFormat(const string& name) {
+    if (name == "png") return CAPTURE_PNG_SEQUENCE;
+    if (name == "raw") return CAPTURE_RAW_STREAM;
+    return CAPTURE_QOI_STREAM;
+}
+
+bool FrameCapture::Start(SDL_Renderer* renderer, const string& outputPath, int poolSize) {
+    if (isRecording) return true;
+
+    this -> renderer = renderer;
+    this -> outputPath = outputPath;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+
+    if (format == CAPTURE_PNG_SEQUENCE) {
+        std::filesystem::create_directories(outputPath);
+    } else {
+        stream = fopen(outputPath.c_str(), "wb");
+        if (!stream) {
+            Logger::Err("Unable to open capture file " + outputPath);
+            return false;
+        }
+        if (format == CAPTURE_RAW_STREAM) {
+            // Raw stream header: magic, then frame width and height
+            uint32_t header[3] = {0x57415246, static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+            fwrite(header, sizeof(header), 1, stream);
+        }
+    }
+
+    // All capture memory is allocated up front and recycled between frames
+    if (static_cast<int>(buffers.size()) != poolSize || (!buffers.empty() && buffers[0] -> pixels.size() != static_cast<size_t>(width * height * 4))) {
+        buffers.clear();
+        for (int i = 0; i < poolSize; i++) {
+            auto buffer = make_unique<CapturedFrame>();
+            buffer -> pixels.resize(width * height * 4);
+            buffers.push_back(move(buffer));
+        }
+    }
+    freeBuffers.clear();
+    for (auto& buffer: buffers) freeBuffers.push_back(buffer.get());
+    pendingFrames.clear();
+
+    capturedCount = 0;
+    droppedCount = 0;
+    encodedCount = 0;
+    isStopping = false;
+    isRecording = true;
+    encoderThread = thread(&FrameCapture::EncoderLoop, this);
+
+    Logger::Log("Started frame capture to {}", outputPath);
+    return true;
+}
+
+void FrameCapture::Stop() {
+    if (!isRecording) return;
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        isStopping = true;
+    }
+    queueCondition.notify_one();
+    encoderThread.join();
+
+    if (stream) fclose(stream);
+    stream = nullptr;
+    isRecording = false;
+
+    Logger::Log(
+        "Stopped frame capture: " + to_string(encodedCount) + " frames written, " +
+        to_string(droppedCount) + " dropped"
+    );
+}
+
+void FrameCapture::CaptureFrame(uint32_t frameNumber) {
+    if (!isRecording) return;
+
+    CapturedFrame* frame = nullptr;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        if (!freeBuffers.empty()) {
+            frame = freeBuffers.back();
+            freeBuffers.pop_back();
+        } else if (dropPolicy == CAPTURE_DROP_OLDEST && !pendingFrames.empty()) {
+            // The oldest queued frame is lost, its buffer takes the new one
+            frame = pendingFrames.front();
+            pendingFrames.pop_front();
+            droppedCount++;
+        }
+    }
+
+    if (!frame) {
+        droppedCount++;
+        return;
+    }
+
+    // The readback is the only copy made on the game thread
+    SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGBA32, frame -> pixels.data(), width * 4);
+    frame -> frameNumber = frameNumber;
+    capturedCount++;
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        pendingFrames.push_back(frame);
+    }
+    queueCondition.notify_one();
+}
+
+void FrameCapture::EncoderLoop() {
+    while (true) {
+        CapturedFrame* frame = nullptr;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]{ return isStopping || !pendingFrames.empty(); });
+            // Drain the queue before honouring a stop request
+            if (pendingFrames.empty()) return;
+            frame = pendingFrames.front();
+            pendingFrames.pop_front();
+        }
+
+        Encode(*frame);
+        encodedCount++;
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            freeBuffers.push_back(frame);
+        }
+    }
+}
+
+void FrameCapture::Encode(const CapturedFrame& frame) {
+    switch (format) {
+        case CAPTURE_PNG_SEQUENCE: {
+            char fileName[32];
+            snprintf(fileName, sizeof(fileName), "/frame_%06u.png", frame.frameNumber);
+            SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(
+                const_cast<uint8_t*>(frame.pixels.data()), width, height, 32, width * 4, SDL_PIXELFORMAT_RGBA32
+            );
+            IMG_SavePNG(surface, (outputPath + fileName).c_str());
+            SDL_FreeSurface(surface);
+            break;
+        }
+        case CAPTURE_QOI_STREAM:
+            encodeBuffer.clear();
+            EncodeQoi(frame.pixels.data(), width, height, encodeBuffer);
+            fwrite(encodeBuffer.data(), 1, encodeBuffer.size(), stream);
+            break;
+        case CAPTURE_RAW_STREAM:
+            fwrite(&frame.frameNumber, sizeof(frame.frameNumber), 1, stream);
+            fwrite(frame.pixels.data(), 1, frame.pixels.size(), stream);
+            break;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <condition_variable>
+#include <SDL2/SDL.h>
+
+using namespace std;
+
+enum CaptureFormat {
+    // One PNG file per frame
+    CAPTURE_PNG_SEQUENCE,
+    // Single file of concatenated QOI images
+    CAPTURE_QOI_STREAM,
+    // Single file of uncompressed RGBA frames after a small header
+    CAPTURE_RAW_STREAM
+};
+
+// What to do when every buffer is busy (the encoder is falling behind)
+enum CaptureDropPolicy {
+    // Skip the frame being captured
+    CAPTURE_DROP_NEWEST,
+    // Throw away the oldest frame still waiting to be encoded and reuse its buffer
+    CAPTURE_DROP_OLDEST
+};
+
+struct CapturedFrame {
+    vector<uint8_t> pixels;
+    uint32_t frameNumber;
+};
+
+// Records rendered frames without stalling the game loop on encoding or disk I/O
+// Frames are read back into a fixed pool of recycled buffers and handed over a
+// bounded queue to a background thread, which encodes and writes them.
+class FrameCapture {
+    private:
+        SDL_Renderer* renderer = nullptr;
+        int width = 0;
+        int height = 0;
+        CaptureFormat format;
+        CaptureDropPolicy dropPolicy;
+        string outputPath;
+        FILE* stream = nullptr;
+
+        // Every buffer ever allocated, plus the ones currently free to capture into
+        vector<unique_ptr<CapturedFrame>> buffers;
+        vector<CapturedFrame*> freeBuffers;
+        // Frames waiting for the encoder, oldest first
+        deque<CapturedFrame*> pendingFrames;
+
+        mutex queueMutex;
+        condition_variable queueCondition;
+        thread encoderThread;
+        bool isRecording = false;
+        bool isStopping = false;
+
+        atomic<uint32_t> capturedCount{0};
+        atomic<uint32_t> droppedCount{0};
+        atomic<uint32_t> encodedCount{0};
+
+        // Scratch buffer used by the encoder thread only
+        vector<uint8_t> encodeBuffer;
+
+        void EncoderLoop();
+        void Encode(const CapturedFrame& frame);
+
+    public:
+        FrameCapture(CaptureFormat format = CAPTURE_QOI_STREAM, CaptureDropPolicy dropPolicy = CAPTURE_DROP_NEWEST);
+        ~FrameCapture();
+
+        // Allocate poolSize frame buffers and start the encoder thread
+        // outputPath is a directory for PNG sequences, or a file for streams
+        bool Start(SDL_Renderer* renderer, const string& outputPath, int poolSize = 8);
+        // Encode every frame still queued, then stop the encoder thread
+        void Stop();
+        bool IsRecording() const { return isRecording; }
+
+        // Copy the current back buffer into a free buffer and queue it; call before SDL_RenderPresent
+        void CaptureFrame(uint32_t frameNumber);
+
+        uint32_t GetCapturedCount() const { return capturedCount; }
+        uint32_t GetDroppedCount() const { return droppedCount; }
+        uint32_t GetEncodedCount() const { return encodedCount; }
+
+        static CaptureFormat ParseFormat(const string& name);
+};
@@ -0,0 +1,93 @@
+#include <fstream>
+#include <sstream>
+#include "../Logger/Logger.h"
+#include "./GoldenFrames.h"
+
+bool GoldenFrames::Open(const std::string& path, bool isWriting, int every, int width, int height) {
+    this -> path = path;
+    this -> isWriting = isWriting;
+    this -> every = every > 0 ? every : 1;
+    this -> width = width;
+    this -> height = height;
+    hashes.clear();
+    if (isWriting) return true;
+
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) {
+        Logger::Err("Could not read the golden file " + path);
+        return false;
+    }
+    std::istringstream header(line);
+    std::string magic;
+    int goldenWidth = 0;
+    int goldenHeight = 0;
+    header >> magic >> goldenWidth >> goldenHeight >> this -> every;
+    if (magic != "golden" || goldenWidth != width || goldenHeight != height) {
+        Logger::Err("Golden file {} is for {}x{}, rendering at {}x{}", path, goldenWidth, goldenHeight, width, height);
+        return false;
+    }
+    if (this -> every != every) Logger::Warn("Golden file {} hashes every {} frames, using that", path, this -> every);
+
+    uint32_t frameNumber;
+    uint64_t hash;
+    while (file >> frameNumber >> std::hex >> hash >> std::dec) hashes[frameNumber] = hash;
+    Logger::Log("Checking frames against {} golden hashes from {}", hashes.size(), path);
+    return true;
+}
+
+uint64_t GoldenFrames::HashSurface(SDL_Surface* surface) {
+    // FNV-1a of the visible pixels, row by row so the pitch padding doesn't count
+    uint64_t hash = 0xcbf29ce484222325ull;
+    if (SDL_MUSTLOCK(surface)) SDL_LockSurface(surface);
+    int rowBytes = surface -> w * surface -> format -> BytesPerPixel;
+    for (int y = 0; y < surface -> h; y++) {
+        auto row = static_cast<const uint8_t*>(surface -> pixels) + y * surface -> pitch;
+        for (int i = 0; i < rowBytes; i++) {
+            hash ^= row[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+    if (SDL_MUSTLOCK(surface)) SDL_UnlockSurface(surface);
+    return hash;
+}
+
+void GoldenFrames::CheckFrame(uint32_t frameNumber, SDL_Surface* surface) {
+    if (!surface || frameNumber % every != 0) return;
+    uint64_t hash = HashSurface(surface);
+    numHashedFrames++;
+    if (isWriting) {
+        hashes[frameNumber] = hash;
+        return;
+    }
+
+    auto golden = hashes.find(frameNumber);
+    if (golden == hashes.end()) {
+        numMissingFrames++;
+    } else if (golden -> second != hash) {
+        if (numMismatchedFrames == 0) Logger::Err("Frame {} doesn't match the golden file", frameNumber);
+        numMismatchedFrames++;
+    }
+}
+
+bool GoldenFrames::Finish() {
+    if (isWriting) {
+        std::ofstream file(path);
+        file << "golden " << width << " " << height << " " << every << "\n";
+        for (auto& [frameNumber, hash]: hashes) file << frameNumber << " " << std::hex << hash << std::dec << "\n";
+        if (!file) {
+            Logger::Err("Could not write the golden file " + path);
+            return false;
+        }
+        Logger::Log("Wrote {} golden frame hashes to {}", hashes.size(), path);
+        return true;
+    }
+
+    if (numMissingFrames > 0) Logger::Warn("{} hashed frames are past the end of the golden file", numMissingFrames);
+    if (numMismatchedFrames > 0) {
+        Logger::Err("{} of {} hashed frames differ from the golden file", numMismatchedFrames, numHashedFrames);
+        return false;
+    }
+    Logger::Log("All {} hashed frames match the golden file", numHashedFrames);
+    return true;
+}
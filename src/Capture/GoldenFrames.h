@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <cstdint>
+#include <SDL2/SDL.h>
+
+// Pixel hashes of rendered frames, checked against (or written to) a golden file
+// File: a "golden WIDTH HEIGHT EVERY" line, then one "FRAME HASH" line per hashed frame.
+// A render change that should be invisible must leave every hash alone.
+class GoldenFrames {
+    private:
+        std::string path;
+        bool isWriting = false;
+        int every = 1;
+        int width = 0;
+        int height = 0;
+        std::map<uint32_t, uint64_t> hashes;
+        int numHashedFrames = 0;
+        int numMismatchedFrames = 0;
+        // Frames past the end of the golden file, the run is longer than the one that wrote it
+        int numMissingFrames = 0;
+
+    public:
+        // Load the golden file, or start a new one when writing; false if there is nothing to check against
+        bool Open(const std::string& path, bool isWriting, int every, int width, int height);
+        // Hash the frame if it is one of every Kth, and check or record it
+        void CheckFrame(uint32_t frameNumber, SDL_Surface* surface);
+        // Write the golden file when writing, and log the result
+        bool Finish();
+
+        int GetNumMismatchedFrames() const { return numMismatchedFrames; }
+
+        static uint64_t HashSurface(SDL_Surface* surface);
+};
@@ -0,0 +1,83 @@
+#include "./QoiEncoder.h"
+
+const uint8_t QOI_OP_INDEX = 0x00;
+const uint8_t QOI_OP_DIFF = 0x40;
+const uint8_t QOI_OP_LUMA = 0x80;
+const uint8_t QOI_OP_RUN = 0xc0;
+const uint8_t QOI_OP_RGB = 0xfe;
+const uint8_t QOI_OP_RGBA = 0xff;
+
+struct QoiPixel {
+    uint8_t r, g, b, a;
+    bool operator ==(const QoiPixel& other) const { return r == other.r && g == other.g && b == other.b && a == other.a; }
+};
+
+static void WriteBigEndian(std::vector<uint8_t>& output, uint32_t value) {
+    output.push_back(value >> 24);
+    output.push_back(value >> 16);
+    output.push_back(value >> 8);
+    output.push_back(value);
+}
+
+void EncodeQoi(const uint8_t* pixels, int width, int height, std::vector<uint8_t>& output) {
+    // Header: magic, size, 4 channels, sRGB with linear alpha
+    output.insert(output.end(), {'q', 'o', 'i', 'f'});
+    WriteBigEndian(output, width);
+    WriteBigEndian(output, height);
+    output.push_back(4);
+    output.push_back(0);
+
+    QoiPixel index[64] = {};
+    QoiPixel previous = {0, 0, 0, 255};
+    int run = 0;
+    int numPixels = width * height;
+
+    for (int i = 0; i < numPixels; i++) {
+        const uint8_t* p = pixels + i * 4;
+        QoiPixel pixel = {p[0], p[1], p[2], p[3]};
+
+        if (pixel == previous) {
+            run++;
+            if (run == 62 || i == numPixels - 1) {
+                output.push_back(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+
+        if (run > 0) {
+            output.push_back(QOI_OP_RUN | (run - 1));
+            run = 0;
+        }
+
+        int hash = (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+        if (index[hash] == pixel) {
+            output.push_back(QOI_OP_INDEX | hash);
+        } else {
+            index[hash] = pixel;
+
+            if (pixel.a == previous.a) {
+                int8_t vr = pixel.r - previous.r;
+                int8_t vg = pixel.g - previous.g;
+                int8_t vb = pixel.b - previous.b;
+                int8_t vgr = vr - vg;
+                int8_t vgb = vb - vg;
+
+                if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                    output.push_back(QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                    output.push_back(QOI_OP_LUMA | (vg + 32));
+                    output.push_back((vgr + 8) << 4 | (vgb + 8));
+                } else {
+                    output.insert(output.end(), {QOI_OP_RGB, pixel.r, pixel.g, pixel.b});
+                }
+            } else {
+                output.insert(output.end(), {QOI_OP_RGBA, pixel.r, pixel.g, pixel.b, pixel.a});
+            }
+        }
+        previous = pixel;
+    }
+
+    // End marker
+    output.insert(output.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+}
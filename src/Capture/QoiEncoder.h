@@ -0,0 +1,9 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Encode an RGBA image (4 bytes per pixel, rows tightly packed) as a QOI image
+// See https://qoiformat.org for the format specification
+// The encoded image is appended to output, so several frames can share one buffer
+void EncodeQoi(const uint8_t* pixels, int width, int height, std::vector<uint8_t>& output);
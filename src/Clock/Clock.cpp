@@ -0,0 +1,3 @@
+#include "./Clock.h"
+
+thread_local Clock* Clock::current = nullptr;
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// Game clock in milliseconds, owned by a Game or a simulated World
+// Components and systems read the time through Clock::Now(), which returns the
+// clock made current on the calling thread. This keeps them independent of SDL
+// and lets several worlds, each with its own clock, run on different threads.
+class Clock {
+    private:
+        uint32_t ticks = 0;
+        static thread_local Clock* current;
+
+    public:
+        Clock() = default;
+
+        void SetTicks(uint32_t ticks) { this -> ticks = ticks; }
+        void Advance(uint32_t milliseconds) { ticks += milliseconds; }
+        uint32_t GetTicks() const { return ticks; }
+
+        // Make this the clock returned by Now() on the calling thread
+        void MakeCurrent() { current = this; }
+
+        // Ticks of the calling thread's current clock (0 if none was made current)
+        static uint32_t Now() { return current ? current -> ticks : 0; }
+};
@@ -0,0 +1,100 @@
+#include "./TimerWheel.h"
+
+TimerWheel::TimerWheel() {
+    // One more list past the levels, for timers that were already due when scheduled
+    heads.assign(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1, -1);
+}
+
+void TimerWheel::Link(int key) {
+    Timer& timer = timers[key];
+    int slot = TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS;
+    if (timer.due > current) {
+        uint32_t delta = timer.due - current;
+        int level = 0;
+        while (level < TIMER_WHEEL_LEVELS - 1 && delta >= (1u << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) level++;
+        slot = level * TIMER_WHEEL_SLOTS + ((timer.due >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    }
+
+    timer.slot = slot;
+    timer.previous = -1;
+    timer.next = heads[slot];
+    if (timer.next >= 0) timers[timer.next].previous = key;
+    heads[slot] = key;
+}
+
+void TimerWheel::Unlink(int key) {
+    Timer& timer = timers[key];
+    if (timer.previous >= 0) {
+        timers[timer.previous].next = timer.next;
+    } else {
+        heads[timer.slot] = timer.next;
+    }
+    if (timer.next >= 0) timers[timer.next].previous = timer.previous;
+    timer.slot = -1;
+}
+
+void TimerWheel::Schedule(int key, uint32_t due) {
+    if (key < 0) return;
+    if (key >= static_cast<int>(timers.size())) timers.resize(key + 1, {0, -1, -1, -1});
+    if (timers[key].slot >= 0) {
+        Unlink(key);
+    } else {
+        numScheduled++;
+    }
+    timers[key].due = due;
+    Link(key);
+}
+
+void TimerWheel::Cancel(int key) {
+    if (!IsScheduled(key)) return;
+    Unlink(key);
+    numScheduled--;
+}
+
+bool TimerWheel::IsScheduled(int key) const {
+    return key >= 0 && key < static_cast<int>(timers.size()) && timers[key].slot >= 0;
+}
+
+void TimerWheel::Cascade(int level, int slot) {
+    int key = heads[level * TIMER_WHEEL_SLOTS + slot];
+    heads[level * TIMER_WHEEL_SLOTS + slot] = -1;
+    while (key >= 0) {
+        int next = timers[key].next;
+        Link(key);
+        key = next;
+    }
+}
+
+void TimerWheel::Expire(int slot, std::vector<int>& expired) {
+    int key = heads[slot];
+    heads[slot] = -1;
+    while (key >= 0) {
+        int next = timers[key].next;
+        timers[key].slot = -1;
+        numScheduled--;
+        expired.push_back(key);
+        key = next;
+    }
+}
+
+void TimerWheel::Advance(uint32_t now, std::vector<int>& expired) {
+    Expire(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS, expired);
+    while (current < now) {
+        // Nothing left to hand out: skip the empty slots altogether
+        if (numScheduled == 0) {
+            current = now;
+            return;
+        }
+        current++;
+        // Crossing into a new span of a level brings its next slot down, the highest level first
+        int cascadeLevels = 0;
+        while (cascadeLevels < TIMER_WHEEL_LEVELS - 1 && ((current >> (TIMER_WHEEL_SLOT_BITS * cascadeLevels)) & (TIMER_WHEEL_SLOTS - 1)) == 0) cascadeLevels++;
+        for (int level = cascadeLevels; level >= 1; level--) {
+            Cascade(level, (current >> (TIMER_WHEEL_SLOT_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+        }
+
+        // Timers cascaded onto this very millisecond went to the overdue list
+        Expire(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS, expired);
+        Expire(current & (TIMER_WHEEL_SLOTS - 1), expired);
+    }
+}
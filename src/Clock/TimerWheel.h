@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+const int TIMER_WHEEL_LEVELS = 4;
+const int TIMER_WHEEL_SLOT_BITS = 8;
+const int TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_SLOT_BITS;
+
+// Hierarchical timer wheel of millisecond deadlines, keyed by small non-negative ints (e.g. entity ids)
+// Level 0 has a slot per millisecond of the next 256, each level above covers 256 times the
+// span of the one below, so all of 32 bits is reachable. Scheduling and cancelling are constant
+// time; advancing visits the slots of the time that passed, and timers move down a level when
+// their slot of a higher level comes up.
+class TimerWheel {
+    private:
+        struct Timer {
+            uint32_t due;
+            // Neighbours in the slot's list, -1 at the ends
+            int previous;
+            int next;
+            // Index into heads, -1 when not scheduled
+            int slot;
+        };
+
+        // [index = key]
+        std::vector<Timer> timers;
+        // First timer of every slot, level by level [index = level * TIMER_WHEEL_SLOTS + slot], then the overdue ones
+        std::vector<int> heads;
+        // Every deadline up to this time has been handed out
+        uint32_t current = 0;
+        int numScheduled = 0;
+
+        void Link(int key);
+        void Unlink(int key);
+        // Move the timers of a higher level slot to where they belong now
+        void Cascade(int level, int slot);
+        // Hand out every timer of the slot
+        void Expire(int slot, std::vector<int>& expired);
+
+    public:
+        TimerWheel();
+
+        // Fire at the due time, replacing the key's earlier deadline; already due ones fire on the next Advance
+        void Schedule(int key, uint32_t due);
+        void Cancel(int key);
+        bool IsScheduled(int key) const;
+
+        // Append the keys whose deadline is now or earlier to expired, in deadline order, and forget them
+        void Advance(uint32_t now, std::vector<int>& expired);
+
+        int GetSize() const { return numScheduled; }
+};
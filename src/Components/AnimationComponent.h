@@ -1,21 +1,48 @@
 #pragma once
 
-#include <SDL2/SDL.h>
+#include <cstdint>
+#include "../Animation/AnimationLibrary.h"
 
+// Facing directions, in the order of the rows of a four way sprite sheet
+enum AnimationFacing: uint8_t {
+    FACING_UP,
+    FACING_RIGHT,
+    FACING_DOWN,
+    FACING_LEFT,
+    NUM_FACINGS
+};
+
+// Playback state of a clip of the AnimationSystem's library, 16 bytes
 struct AnimationComponent{
-    int numFrames;
-    int currentFrame;
-    int frameRateSpeed;
-    int startTime;
-    bool isLoop;
+    uint16_t clip;
+    uint16_t frame;
+    // Milliseconds spent in the current frame
+    uint16_t frameTime;
+    // Playing the frames backwards (second half of a ping-pong)
+    bool isReversed;
+    // Frame changed or the clip was just started: the sprite's source rectangle and the frame's event are due
+    bool isFrameEntered;
+    // Clip for each facing, NO_ANIMATION_CLIP to keep the current one
+    uint16_t facingClips[NUM_FACINGS];
 
-    AnimationComponent(int numFrames = 1, int frameRateSpeed = 1, bool isLoop = true){
-        this -> numFrames = numFrames;
-        this -> currentFrame = 1;
-        this -> frameRateSpeed = frameRateSpeed;
-        this -> isLoop = isLoop;
-        this -> startTime = SDL_GetTicks();
+    AnimationComponent(uint16_t clip = NO_ANIMATION_CLIP){
+        this -> clip = clip;
+        this -> frame = 0;
+        this -> frameTime = 0;
+        this -> isReversed = false;
+        this -> isFrameEntered = true;
+        for (auto& facingClip: facingClips) facingClip = NO_ANIMATION_CLIP;
     }
-};
-
 
+    // Start another clip, from its first frame or, to turn without a hitch, at the same frame and time
+    void Play(uint16_t newClip, bool isPhaseKept = false){
+        if (newClip == clip && isPhaseKept) return;
+        clip = newClip;
+        if (!isPhaseKept) {
+            frame = 0;
+            frameTime = 0;
+            isReversed = false;
+        }
+        isFrameEntered = true;
+    }
+};
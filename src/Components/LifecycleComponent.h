@@ -1,12 +1,13 @@
 #pragma once
 
-#include <SDL2/SDL.h>
+#include <cstdint>
+#include "../Clock/Clock.h"
 
 struct LifecycleComponent {
     int timeToLive;
     uint32_t startTime
         ;
-    LifecycleComponent(int timeToLive = 1000, uint32_t startTime = SDL_GetTicks()) {
+    LifecycleComponent(int timeToLive = 1000, uint32_t startTime = Clock::Now()) {
         this -> timeToLive = timeToLive;
         this -> startTime = startTime;
     }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+struct NavigationComponent {
+    int speed;
+    std::string targetTag;
+    // Index of the shared flow field steering this entity, resolved by the NavigationSystem
+    int flowFieldId;
+
+    NavigationComponent(int speed = 0, std::string targetTag = "player") {
+        this -> speed = speed;
+        this -> targetTag = targetTag;
+        this -> flowFieldId = -1;
+    }
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Emits particles of a level's emitter definition from the entity, continuously
+struct ParticleEmitterComponent {
+    int definition;
+    // From the entity's position
+    glm::vec2 offset;
+    // Particles per second
+    float rate;
+    // Fraction of a particle left over from the last frame
+    float pending;
+    bool isEmitting;
+
+    ParticleEmitterComponent(int definition = -1, glm::vec2 offset = glm::vec2(0), float rate = 0.0f, bool isEmitting = true) {
+        this -> definition = definition;
+        this -> offset = offset;
+        this -> rate = rate;
+        this -> pending = 0.0f;
+        this -> isEmitting = isEmitting;
+    }
+};
@@ -1,7 +1,11 @@
 #pragma once
 
-#include <SDL2/SDL.h>
+#include "../Clock/Clock.h"
 #include <glm/glm.hpp>
+
+// Projectiles an emitter keeps for reuse when the level doesn't say
+const int DEFAULT_PROJECTILE_POOL_SIZE = 16;
+
 struct ProjectileEmitterComponent {
     glm::vec2 projectileVelocity;
     int projectileFrequency;
@@ -10,14 +14,18 @@ struct ProjectileEmitterComponent {
     int projectileDamageLayer;
     bool isAuto;
     int lastFiredTime;
+    // Projectiles made up front and recycled when they die; past that many in flight they are
+    // created and destroyed as usual. 0 turns recycling off.
+    int projectilePoolSize;
 
-    ProjectileEmitterComponent(glm::vec2 projectileVelocity = glm::vec2(0), int projectileFrequency = 0, int projectileDuration = 10000, int projectileDamage = 10, int projectileDamageLayer = 1, bool isAuto = true) {
+    ProjectileEmitterComponent(glm::vec2 projectileVelocity = glm::vec2(0), int projectileFrequency = 0, int projectileDuration = 10000, int projectileDamage = 10, int projectileDamageLayer = 1, bool isAuto = true, int projectilePoolSize = DEFAULT_PROJECTILE_POOL_SIZE) {
         this -> projectileVelocity = projectileVelocity;
         this -> projectileFrequency = projectileFrequency;
         this -> projectileDuration = projectileDuration;
         this -> projectileDamage = projectileDamage;
         this -> projectileDamageLayer = projectileDamageLayer;
         this -> isAuto = isAuto;
-        this -> lastFiredTime = SDL_GetTicks(); 
+        this -> lastFiredTime = Clock::Now(); 
+        this -> projectilePoolSize = projectilePoolSize;
     }
 };
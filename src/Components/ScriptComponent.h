@@ -0,0 +1,10 @@
+#pragma once
+
+// Runs a Lua behaviour every frame; the script itself lives in ScriptSystem
+struct ScriptComponent {
+    int scriptId;
+
+    ScriptComponent(int scriptId = -1) {
+        this -> scriptId = scriptId;
+    }
+};
@@ -7,17 +7,19 @@ struct SpriteComponent{
     std::string assetId;
     int width;
     int height;
-    int zIndex;
+    // Index into the RenderSystem's layers, which the level names
+    int layer;
     SDL_RendererFlip flip;
     bool isFixed;
+    // Relative to the texture, the renderer adds where the texture is in its atlas page
     SDL_Rect srcRect;
     std::string direction; 
 
-    SpriteComponent(std::string assetId = "", int width = 0, int height = 0, int zIndex = 0, bool isFixed = false, int srcRectX = 0, int srcRectY = 0, std::string direction = "Right"){
+    SpriteComponent(std::string assetId = "", int width = 0, int height = 0, int layer = 0, bool isFixed = false, int srcRectX = 0, int srcRectY = 0, std::string direction = "Right"){
         this -> assetId = assetId;
         this -> width = width;
         this -> height = height;
-        this -> zIndex = zIndex;
+        this -> layer = layer;
         this -> flip = SDL_FLIP_NONE;
         this -> isFixed = isFixed;
         this -> srcRect = {srcRectX, srcRectY, width, height};
@@ -25,5 +27,3 @@ struct SpriteComponent{
     }
 };
 
-
-// TODO: Replace int zIndex with a layer parameter that groups sprites in the z axis by a named layer
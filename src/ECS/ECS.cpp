@@ -1,7 +1,7 @@
 #include <vector>
 #include <algorithm>
 #include "ECS.h"
-#include "../Components/SpriteComponent.h"
+#include "../Telemetry/Telemetry.h"
 
 using namespace std;
 
@@ -31,20 +31,27 @@ bool Entity::BelongsToGroup(const string& group) const {
 }
 
 //--------COMPONENT
-int IComponent::nextId = 0;
+atomic<int> IComponent::nextId{0};
 
 //--------SYSTEM
 void System::AddEntityToSystem(Entity entity){
+    int entityId = entity.GetId();
+    if (entityId >= static_cast<int>(entityIndices.size())) entityIndices.resize(entityId + 1, -1);
+    if (entityIndices[entityId] >= 0) return;
+    entityIndices[entityId] = entities.size();
     entities.push_back(entity);
-
-    sort(entities.begin(), entities.end(), [](Entity a, Entity b){
-                if (!a.HasComponent<SpriteComponent>() || !b.HasComponent<SpriteComponent>()) return false;
-                return (a.GetComponent<SpriteComponent>().zIndex < b.GetComponent<SpriteComponent>().zIndex);
-            });
+    OnEntityAdded(entity);
 }
 
 void System::RemoveEntityFromSystem(Entity entity){
-    erase(entities, entity);
+    int entityId = entity.GetId();
+    if (entityId >= static_cast<int>(entityIndices.size()) || entityIndices[entityId] < 0) return;
+    int index = entityIndices[entityId];
+    entities[index] = entities.back();
+    entityIndices[entities[index].GetId()] = index;
+    entities.pop_back();
+    entityIndices[entityId] = -1;
+    OnEntityRemoved(entity);
 }
 
 vector<Entity>& System::GetSystemEntities(){
@@ -67,12 +74,16 @@ Entity Registry::CreateEntity(){
         // Resize entityComponentSignatures vector as needed
         if (entityId >= static_cast<int>(entityComponentSignatures.size())){
             entityComponentSignatures.resize(entityId + 1);
+            entityGenerations.resize(entityId + 1, 0);
+            entityRecyclePools.resize(entityId + 1, -1);
+            inactiveEntities.resize(entityId + 1, false);
         }
     } else {
         // Reuse entity ID if one is available
         entityId = freeIds.front();
         freeIds.pop_front();
     }
+    entityGenerations[entityId]++;
 
     Entity entity(entityId);
     // Set the entry's parent registry to the current registry
@@ -83,14 +94,46 @@ Entity Registry::CreateEntity(){
 }
 
 void Registry::KillEntity(Entity entity){
+    // Ignore entities whose id has already been freed
+    if (!IsEntityAlive(entity.GetId())) return;
+    if (entityRecyclePools[entity.GetId()] >= 0) {
+        if (!inactiveEntities[entity.GetId()]) entitiesToBeDeactivated.insert(entity);
+        return;
+    }
     entitiesToBeKilled.insert(entity);
 }
 
+bool Registry::IsEntityAlive(int entityId) const {
+    return entityId >= 0 && entityId < numEntities && entityGenerations[entityId] % 2 == 1;
+}
+
+bool Registry::IsEntityActive(int entityId) const {
+    return IsEntityAlive(entityId) && !inactiveEntities[entityId];
+}
+
+EntityHandle Registry::GetHandle(Entity entity) const {
+    return {entity.GetId(), entityGenerations[entity.GetId()]};
+}
+
+bool Registry::IsValid(EntityHandle handle) const {
+    return IsEntityActive(handle.id) && entityGenerations[handle.id] == handle.generation;
+}
+
+Entity Registry::GetEntity(EntityHandle handle) {
+    Entity entity(handle.id);
+    entity.registry = this;
+    return entity;
+}
+
+const Signature& Registry::GetEntitySignature(int entityId) const {
+    return entityComponentSignatures[entityId];
+}
+
 void Registry::AddEntityToSystems(Entity entity){
     const auto entityId = entity.GetId();
 
-    // Get entity component signature
-    const auto& entityComponentSignature = entityComponentSignatures[entityId];
+    // Get entity component signature, a copy: systems may create entities when one is added
+    const auto entityComponentSignature = entityComponentSignatures[entityId];
 
     // Loop over all systems to get system component signatures
     for (auto& system: systems){
@@ -112,6 +155,52 @@ void Registry::RemoveEntityFromSystems(Entity entity){
     }
 }
 
+// Manage recycle pools
+int Registry::CreateRecyclePool() {
+    if (!freeRecyclePoolIds.empty()) {
+        int poolId = freeRecyclePoolIds.front();
+        freeRecyclePoolIds.pop_front();
+        return poolId;
+    }
+    recyclePools.emplace_back();
+    recyclePoolMembers.emplace_back();
+    return recyclePools.size() - 1;
+}
+
+void Registry::AddToRecyclePool(Entity entity, int poolId) {
+    int entityId = entity.GetId();
+    if (!IsEntityAlive(entityId) || poolId < 0 || poolId >= static_cast<int>(recyclePools.size())) return;
+    entitiesToBeAdded.erase(entity);
+    entityRecyclePools[entityId] = poolId;
+    inactiveEntities[entityId] = true;
+    recyclePools[poolId].push_back(entity);
+    recyclePoolMembers[poolId].push_back(entity);
+}
+
+bool Registry::TakeFromRecyclePool(int poolId, Entity& entity) {
+    if (poolId < 0 || poolId >= static_cast<int>(recyclePools.size()) || recyclePools[poolId].empty()) return false;
+    entity = recyclePools[poolId].back();
+    recyclePools[poolId].pop_back();
+    inactiveEntities[entity.GetId()] = false;
+    entitiesToBeAdded.insert(entity);
+    return true;
+}
+
+void Registry::ReleaseRecyclePool(int poolId) {
+    if (poolId < 0 || poolId >= static_cast<int>(recyclePools.size())) return;
+    // Members stay in the pool until it is released, killing one only deactivates it
+    for (auto entity: recyclePoolMembers[poolId]) entityRecyclePools[entity.GetId()] = -1;
+    for (auto entity: recyclePools[poolId]) KillEntity(entity);
+    recyclePools[poolId].clear();
+    recyclePoolMembers[poolId].clear();
+    freeRecyclePoolIds.push_back(poolId);
+}
+
+int Registry::GetRecyclePoolSize(int poolId) const {
+    if (poolId < 0 || poolId >= static_cast<int>(recyclePools.size())) return 0;
+    return recyclePools[poolId].size();
+}
+
 // Manage entity groups and tags
 void Registry::TagEntity(Entity entity, const string& tag) {
     entityPerTag.emplace(tag, entity);
@@ -129,6 +218,10 @@ Entity Registry::GetEntityByTag(const string& tag) const {
     return entityPerTag.at(tag);
 }
 
+bool Registry::HasEntityWithTag(const string& tag) const {
+    return entityPerTag.find(tag) != entityPerTag.end();
+}
+
 void Registry::RemoveEntityTag(Entity entity) {
     auto taggedEntity = tagPerEntity.find(entity.GetId());
     if (taggedEntity != tagPerEntity.end()) {
@@ -156,6 +249,14 @@ vector<Entity> Registry::GetEntitiesByGroup(const string& group) const {
     return vector<Entity>(setOfEntities.begin(), setOfEntities.end());
 }
 
+std::pmr::vector<Entity> Registry::GetEntitiesByGroup(const string& group, std::pmr::memory_resource* memory) const {
+    std::pmr::vector<Entity> entities(memory);
+    auto setOfEntities = entitiesPerGroup.find(group);
+    if (setOfEntities == entitiesPerGroup.end()) return entities;
+    entities.assign(setOfEntities -> second.begin(), setOfEntities -> second.end());
+    return entities;
+}
+
 void Registry::RemoveEntityGroup(Entity entity) {
     // Check to see if the entity is in any groups 
     auto groupedEntity = groupPerEntity.find(entity.GetId());
@@ -175,15 +276,50 @@ void Registry::RemoveEntityGroup(Entity entity) {
 
 }
 
+int Registry::GetNumEntities() const {
+    return numEntities - freeIds.size();
+}
+
+void Registry::PublishTelemetry() const {
+    Telemetry::Set(TELEMETRY_ENTITY_COUNT, GetNumEntities());
+    for (int componentId = 0; componentId < static_cast<int>(componentPools.size()); componentId++) {
+        const auto& pool = componentPools[componentId];
+        if (pool) Telemetry::SetPoolSize(componentId, pool -> GetName(), pool -> GetSize());
+    }
+}
+
 void Registry::Update(){
+    // Entities created, killed or recycled from the system callbacks below wait for the next update
+    set<Entity> added;
+    set<Entity> deactivated;
+    set<Entity> killed;
+    added.swap(entitiesToBeAdded);
+    deactivated.swap(entitiesToBeDeactivated);
+    killed.swap(entitiesToBeKilled);
+
     // Process entities that are waiting to be created 
-    for (auto entity: entitiesToBeAdded){
+    for (auto entity: added){
         AddEntityToSystems(entity);   
     }
-    entitiesToBeAdded.clear();
+
+    // Recycled entities leave their systems and wait in their pool
+    for (auto entity: deactivated){
+        int entityId = entity.GetId();
+        int poolId = entityRecyclePools[entityId];
+        // The pool was released since it was killed
+        if (poolId < 0) {
+            KillEntity(entity);
+            continue;
+        }
+        RemoveEntityFromSystems(entity);
+        inactiveEntities[entityId] = true;
+        // Handles to this life of the entity are invalid from now on; it stays alive (odd)
+        entityGenerations[entityId] += 2;
+        recyclePools[poolId].push_back(entity);
+    }
 
     // Process entities that are waiting to be killed
-    for (auto entity: entitiesToBeKilled){
+    for (auto entity: killed){
         // Remove entity from component pools
         for (auto pool: componentPools) {
             if (pool) pool -> RemoveEntityFromPool(entity.GetId());
@@ -191,13 +327,15 @@ void Registry::Update(){
 
         RemoveEntityFromSystems(entity);
         entityComponentSignatures[entity.GetId()].reset();
+        entityRecyclePools[entity.GetId()] = -1;
+        inactiveEntities[entity.GetId()] = false;
 
-        // Make entity ID available for reuse
+        // Make entity ID available for reuse, invalidating handles to it
         freeIds.push_back(entity.GetId());
+        entityGenerations[entity.GetId()]++;
         
         // Remove entity from group/tag maps
         RemoveEntityTag(entity);
         RemoveEntityGroup(entity);
     }
-    entitiesToBeKilled.clear();
 }
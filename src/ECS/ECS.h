@@ -4,8 +4,11 @@
 #include <deque>
 #include <vector>
 #include <bitset>
+#include <cstdint>
+#include <atomic>
 #include <memory>
 #include <typeindex>
+#include <memory_resource>
 #include <unordered_map>
 
 using namespace std;
@@ -43,13 +46,22 @@ class Entity{
         template <typename TComponent> TComponent& GetComponent() const;
 
         //Hold a pointer to the entity's owner registry
-        class Registry* registry;
+        class Registry* registry = nullptr;
+};
+
+// An entity id plus the generation of that id it refers to
+// Ids are recycled, so code that holds on to an entity across frames (e.g. scripts) keeps a handle
+// and asks the registry whether it is still valid before touching its components.
+struct EntityHandle{
+    int id = -1;
+    uint32_t generation = 0;
 };
 
 //--------COMPONENT
 struct IComponent{
     protected:
-        static int nextId;
+        // Atomic so worlds running on different threads can register component types safely
+        static atomic<int> nextId;
 };
 
 // Assign a unique ID to each component type
@@ -69,14 +81,22 @@ class System{
     private:
         Signature componentSignature;
         vector<Entity> entities;
+        // Position of each entity in entities, -1 if it isn't there [index = entity id]
+        vector<int> entityIndices;
     public:
         System() = default;
         virtual ~System() = default;
         
+        // Both are constant time; removing moves the last entity into the freed place
         void AddEntityToSystem(Entity entity);
         void RemoveEntityFromSystem(Entity entity);
         vector<Entity>& GetSystemEntities();
         const Signature& GetComponentSignature() const;
+
+        // Called after an entity joins the system, and when it leaves (after its components are
+        // gone when it was killed)
+        virtual void OnEntityAdded(Entity entity) {}
+        virtual void OnEntityRemoved(Entity entity) {}
         
         // Defines the component type that entities must have to be considered by the system
         template <typename TComponent> void RequireComponent(); 
@@ -94,6 +114,9 @@ class IPool{
     public:
         virtual ~IPool() = default;
         virtual void RemoveEntityFromPool(int entityId) = 0;
+        virtual int GetSize() const = 0;
+        // Name of the component type stored in the pool
+        virtual const char* GetName() const = 0;
 };
 template <typename T>
 class Pool: public IPool{
@@ -112,10 +135,17 @@ class Pool: public IPool{
             return data.empty();
         }
 
-        int GetSize() const{
+        int GetSize() const override{
             return data.size();
         }
 
+        const char* GetName() const override{
+            // Mangled names of plain structs are the name prefixed by its length, e.g. 18TransformComponent
+            const char* name = typeid(T).name();
+            while (*name >= '0' && *name <= '9') name++;
+            return name;
+        }
+
         void Reserve(int n){
             data.reserve(n);
         }
@@ -174,6 +204,11 @@ class Pool: public IPool{
         T& operator [](unsigned int index){
             return data[index];
         }
+
+        // Call function(entityId, component) for every component in the pool, in no particular order
+        template <typename TFunction> void ForEach(TFunction function) const {
+            for (auto& element: indexToEntityId) function(element.second, data[element.first]);
+        }
 };
 
 //--------REGISTRY
@@ -216,6 +251,22 @@ class Registry{
         // List of available entity IDs from previously removed entities
         deque<int> freeIds;
 
+        // Bumped when an id is handed out and when it is freed: odd while the entity is alive
+        // [index = entity id]
+        vector<uint32_t> entityGenerations;
+
+        // Entities of recycle pools that were killed this frame, they are deactivated instead
+        set<Entity> entitiesToBeDeactivated;
+        // Recycle pool of each entity, -1 if none [index = entity id]
+        vector<int> entityRecyclePools;
+        // Deactivated entities, out of every system until they are taken again [index = entity id]
+        vector<bool> inactiveEntities;
+        // Inactive entities of each pool, ready to be taken [index = pool id]
+        vector<vector<Entity>> recyclePools;
+        // Every entity of each pool, active or not [index = pool id]
+        vector<vector<Entity>> recyclePoolMembers;
+        deque<int> freeRecyclePoolIds;
+
     public:
         Registry() = default;
 
@@ -224,12 +275,39 @@ class Registry{
         // Entity management        
         Entity CreateEntity(); 
         void KillEntity(Entity entity);
+        bool IsEntityAlive(int entityId) const;
+        EntityHandle GetHandle(Entity entity) const;
+        // The handle's entity is alive and its id hasn't been reused since the handle was taken
+        bool IsValid(EntityHandle handle) const;
+        Entity GetEntity(EntityHandle handle);
+        const Signature& GetEntitySignature(int entityId) const;
+        // Alive and not waiting in a recycle pool
+        bool IsEntityActive(int entityId) const;
+        // Call function(entity) for every active entity that has all the components of the signature
+        template <typename TFunction> void ForEachEntityWith(const Signature& signature, TFunction function);
         
+        // Recycle pools, for entities made and destroyed at a high rate (e.g. projectiles)
+        // Killing an entity of a pool deactivates it instead: it leaves every system but keeps its id,
+        // components, group and tag, so it can be reused by resetting the fields that differ. Handles
+        // to it become invalid when it is deactivated.
+        int CreateRecyclePool();
+        // Put an entity created this frame into the pool, inactive, instead of adding it to the systems
+        void AddToRecyclePool(Entity entity, int poolId);
+        // Activate one of the pool's inactive entities, it joins its systems in the next update like a
+        // new entity; false if the pool has none
+        bool TakeFromRecyclePool(int poolId, Entity& entity);
+        // Kill the pool's inactive entities and forget the pool; its active ones die for real when killed
+        void ReleaseRecyclePool(int poolId);
+        // Inactive entities waiting in the pool
+        int GetRecyclePoolSize(int poolId) const;
+
         // Component management
         template <typename TComponent, typename ...TArgs> void AddComponent(Entity entity, TArgs&& ...args);
         template <typename TComponent> void RemoveComponent(Entity entity);
         template <typename TComponent> bool HasComponent(Entity entity) const;
         template <typename TComponent> TComponent& GetComponent(Entity entity) const;
+        // Call function(entityId, component) for every component of the type, in no particular order
+        template <typename TComponent, typename TFunction> void ForEachComponent(TFunction function) const;
         
         // System management
         template <typename TSystem, typename ...TArgs> void AddSystem(TArgs&& ...args);
@@ -246,14 +324,22 @@ class Registry{
         void TagEntity(Entity entity, const string& tag);
         bool EntityHasTag(Entity entity, const string& tag) const;
         Entity GetEntityByTag(const string& tag) const;
+        bool HasEntityWithTag(const string& tag) const;
         void RemoveEntityTag(Entity entity);
 
         // Group management
         void GroupEntity(Entity entity, const string& group);
         bool EntityBelongsToGroup(Entity entity, const string& group) const;
         vector<Entity> GetEntitiesByGroup(const string& group) const;
+        // Same, with the vector's memory taken from the given resource (e.g. the frame arena)
+        std::pmr::vector<Entity> GetEntitiesByGroup(const string& group, std::pmr::memory_resource* memory) const;
         void RemoveEntityGroup(Entity entity);       
         
+        // Number of entities alive (created and not yet recycled)
+        int GetNumEntities() const;
+        // Publish the entity count and the size of every component pool as telemetry gauges
+        void PublishTelemetry() const;
+
         // Add and remove entities from systems based on component signatures
         void AddEntityToSystems(Entity entity);
         void RemoveEntityFromSystems(Entity entity);
@@ -350,6 +436,24 @@ TComponent& Registry::GetComponent(Entity entity) const{
     return componentPool -> Get(entityId);
 }
 
+template <typename TComponent, typename TFunction>
+void Registry::ForEachComponent(TFunction function) const{
+    const auto componentId = Component<TComponent>::GetId();
+    if (componentId >= static_cast<int>(componentPools.size()) || !componentPools[componentId]) return;
+    static_pointer_cast<Pool<TComponent>>(componentPools[componentId]) -> ForEach(function);
+}
+
+template <typename TFunction>
+void Registry::ForEachEntityWith(const Signature& signature, TFunction function){
+    // Signatures of free ids are reset, so only living entities can match
+    for (int entityId = 0; entityId < numEntities; entityId++) {
+        if ((entityComponentSignatures[entityId] & signature) != signature || inactiveEntities[entityId]) continue;
+        Entity entity(entityId);
+        entity.registry = this;
+        function(entity);
+    }
+}
+
 template <typename TSystem, typename ...TArgs> 
 void Registry::AddSystem(TArgs&& ...args){
     // Create a new system using the constructor 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Logger/Logger.h"
+#include "../Telemetry/Telemetry.h"
 #include "Event.h"
 
 #include <functional>
@@ -100,6 +101,7 @@ class EventBus {
             auto handlers = subscribers[typeid(TEvent)].get();
             // Define the event: The parameters that the handler functions will be called with
             TEvent event(forward<TArgs>(args)...);
+            Telemetry::Add(TELEMETRY_EVENTS_DISPATCHED);
             if (handlers) {
                 // Loop over all handlers and execute them with the event parameters
                 for (auto it = handlers -> begin(); it != handlers -> end(); it++){
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include "../EventBus/Event.h"
+#include "../ECS/ECS.h"
+
+// An entity's animation entered a frame that has an event
+class AnimationEvent: public Event {
+    public:
+        Entity entity;
+        const std::string& name;
+        AnimationEvent(Entity entity, const std::string& name): entity(entity), name(name) {}
+};
@@ -0,0 +1,46 @@
+#include "./FrameWorker.h"
+
+FrameWorker::~FrameWorker() {
+    Stop();
+}
+
+void FrameWorker::Start(std::function<void()> job) {
+    if (thread.joinable()) return;
+    this -> job = std::move(job);
+    isStopping = false;
+    thread = std::thread(&FrameWorker::Loop, this);
+}
+
+void FrameWorker::Loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        condition.wait(lock, [this]() { return hasWork || isStopping; });
+        if (isStopping && !hasWork) return;
+        lock.unlock();
+        job();
+        lock.lock();
+        hasWork = false;
+        condition.notify_all();
+    }
+}
+
+void FrameWorker::Kick() {
+    std::lock_guard<std::mutex> lock(mutex);
+    hasWork = true;
+    condition.notify_all();
+}
+
+void FrameWorker::Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() { return !hasWork; });
+}
+
+void FrameWorker::Stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+        condition.notify_all();
+    }
+    thread.join();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+// A thread that runs the same job once per Kick(), so a frame's work can overlap the main thread's
+// Kick() and Wait() are called from one thread, in pairs; everything written before Kick() is
+// visible to the job, and everything the job wrote is visible after Wait().
+class FrameWorker {
+    private:
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::function<void()> job;
+        bool hasWork = false;
+        bool isStopping = false;
+
+        void Loop();
+
+    public:
+        FrameWorker() = default;
+        FrameWorker(const FrameWorker&) = delete;
+        FrameWorker& operator=(const FrameWorker&) = delete;
+        ~FrameWorker();
+
+        void Start(std::function<void()> job);
+        // Run the job once on the worker
+        void Kick();
+        // Until the job started by the last Kick() is done
+        void Wait();
+        void Stop();
+        bool IsStarted() const { return thread.joinable(); }
+};
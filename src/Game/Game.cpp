@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL.h>
 #include <glm/glm.hpp>
@@ -5,24 +6,25 @@
 #include <imgui/imgui_impl_sdl2.h>
 #include <imgui/imgui_impl_sdlrenderer2.h>
 
-#include "../Systems/KeyboardMovementSystem.h"
-#include "../Systems/ProjectileEmitSystem.h"
 #include "../Systems/RenderColliderSystem.h"
-#include "../Systems/CameraMovementSystem.h"
 #include "../Systems/RenderHealthSystem.h"
 #include "../Systems/RenderTextSystem.h"
 #include "../Systems/RenderGUISystem.h"
-#include "../Systems/AnimationSystem.h"
-#include "../Systems/LifecycleSystem.h"
-#include "../Systems/CollisionSystem.h"
-#include "../Systems/MovementSystem.h"
-#include "../Systems/DamageSystem.h"
 #include "../Systems/RenderSystem.h"
+#include "../Systems/ParticleSystem.h"
 
 #include "../Events/KeyReleasedEvent.h"
 #include "../Events/KeyPressedEvent.h"
 #include "../Logger/Logger.h"
+#include "../Telemetry/Telemetry.h"
+#include "../Profiler/StartupTimeline.h"
+#include "../Profiler/AllocationTracker.h"
+#include "../Memory/FrameArena.h"
+#include "../Replay/WorldHash.h"
 #include "./LevelLoader.h"
+#include "./GameSystems.h"
+#include "../Scripting/LuaBindings.h"
+#include "../Systems/ScriptSystem.h"
 #include "../ECS/ECS.h"
 #include "./Game.h"
 
@@ -31,7 +33,9 @@ int Game::windowHeight;
 int Game::mapWidth;
 int Game::mapHeight;
 
-Game::Game(){
+Game::Game(const GameConfig& config){
+    this -> config = config;
+    if (!config.logFile.empty()) Logger::OpenFile(config.logFile);
     isRunning = false;
     isDebug = false;
     
@@ -39,6 +43,12 @@ Game::Game(){
     assetStore = std::make_unique<AssetStore>(renderer);
     registry = std::make_unique<Registry>(); 
     eventBus = std::make_unique<EventBus>(); 
+    navGrid = std::make_unique<NavGrid>();
+    tileLayer = std::make_unique<TileLayer>();
+    frameCapture = std::make_unique<FrameCapture>(
+        FrameCapture::ParseFormat(config.captureFormat),
+        config.captureDropOldest ? CAPTURE_DROP_OLDEST : CAPTURE_DROP_NEWEST
+    );
     
     Logger::Log("Game constructor called!");
 }
@@ -48,7 +58,25 @@ Game::~Game(){
 }
 
 void Game::Initialize() {
-    if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+    // A replay starts from the level and seed it was recorded with
+    if (!config.replayPath.empty() && inputJournal.StartReplay(config.replayPath)) {
+        levelNumber = inputJournal.GetHeader().level;
+    }
+
+    // The level script and its images don't need SDL video, load them while the window comes up
+    levelBootTask = std::async(std::launch::async, [this]() {
+        {
+            StartupPhase phase("lua_state");
+            lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::coroutine);
+        }
+        LevelLoader::Preload(lua, levelNumber, levelBoot);
+    });
+
+    StartupPhase phase("sdl_video");
+    // Headless runs use the dummy video driver, which still gives us events and timers
+    if (config.isHeadless || config.isHeadlessRender) SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    // Events and timers come with the video subsystem
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         Logger::Err("Error initializing SDL."); 
         return;
     }
@@ -61,27 +89,59 @@ void Game::Initialize() {
     SDL_DisplayMode displayMode;
     SDL_GetCurrentDisplayMode(0, &displayMode);
     
-    windowWidth = displayMode.w; 
-    windowHeight = displayMode.h;
+    windowWidth = config.isHeadlessRender ? config.renderWidth : displayMode.w; 
+    windowHeight = config.isHeadlessRender ? config.renderHeight : displayMode.h;
+
+    if (config.useTelemetry) Telemetry::Open();
+    if (config.trackAllocations) AllocationTracker::Enable(config.assertZeroAllocations);
+
+    // Initialize camera view with the entire screen area
+    isRunning = true;
+    camera = {0, 0, windowWidth, windowHeight};
+    // Nothing is drawn, so no window, renderer or textures
+    if (config.isHeadless) return;
     
-    SDL_CreateWindowAndRenderer(windowWidth, windowHeight, SDL_WINDOW_BORDERLESS, &window, &renderer);
-    if (!window || !renderer){
-        Logger::Err("Error creating SDL Window or Renderer!");
+    if (config.isHeadlessRender) {
+        // No window: the software renderer draws straight into a surface we can hash
+        renderSurface = SDL_CreateRGBSurfaceWithFormat(0, windowWidth, windowHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        renderer = renderSurface ? SDL_CreateSoftwareRenderer(renderSurface) : NULL;
+        if (!renderer) {
+            Logger::Err("Error creating the offscreen software renderer: {}", SDL_GetError());
+            exitCode = 1;
+            isRunning = false;
+            return;
+        }
+        Logger::Log("Rendering offscreen at {}x{}", windowWidth, windowHeight);
+
+        if (!config.goldenPath.empty()) {
+            goldenFrames = std::make_unique<GoldenFrames>();
+            if (!goldenFrames -> Open(config.goldenPath, config.isWritingGolden, config.goldenEvery, windowWidth, windowHeight)) {
+                goldenFrames.reset();
+                exitCode = 1;
+                isRunning = false;
+                return;
+            }
+        }
+    } else {
+        window = SDL_CreateWindow(NULL, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, windowWidth, windowHeight, SDL_WINDOW_BORDERLESS);
+        Uint32 rendererFlags = config.useSoftwareRenderer ? SDL_RENDERER_SOFTWARE : 0;
+        renderer = window ? SDL_CreateRenderer(window, -1, rendererFlags) : NULL;
+        if (!window || !renderer){
+            Logger::Err("Error creating SDL Window or Renderer!");
+        }
+        
+        SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
+    }
+
+    // Golden frames must come out the same on every run, a scale that follows the frame time wouldn't
+    if (config.useDynamicResolution && goldenFrames) {
+        Logger::Warn("Dynamic resolution is off while checking or writing golden frames");
+    } else if (config.useDynamicResolution) {
+        double targetFrameTime = config.targetFrameTime > 0 ? config.targetFrameTime : MS_PER_FRAME;
+        dynamicResolution = std::make_unique<DynamicResolution>(config.minResolutionScale, config.maxResolutionScale, targetFrameTime);
+        if (!dynamicResolution -> Initialize(renderer, windowWidth, windowHeight)) dynamicResolution.reset();
     }
-    
-    SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN_DESKTOP);
     assetStore -> SetRenderer(renderer);
-    isRunning = true;
-    
-    // Initialize ImGui
-    ImGui::CreateContext();
-    ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
-    ImGui_ImplSDLRenderer2_Init(renderer);
-    // Initialize camera view with the entire screen area
-    camera.x = 0;
-    camera.y = 0;
-    camera.w = windowWidth;
-    camera.h = windowHeight;
 }
 
 
@@ -89,15 +149,17 @@ void Game::ProcessInput(){
     SDL_Event sdlEvent;
     while(SDL_PollEvent(&sdlEvent)){
         // ImGui SDL input
-        ImGui_ImplSDL2_ProcessEvent(&sdlEvent);
-        ImGuiIO& io = ImGui::GetIO();
+        if (isImGuiInitialized) {
+            ImGui_ImplSDL2_ProcessEvent(&sdlEvent);
+            ImGuiIO& io = ImGui::GetIO();
 
-        int mouseX, mouseY;
-        const int buttons = SDL_GetMouseState(&mouseX, &mouseY);
+            int mouseX, mouseY;
+            const int buttons = SDL_GetMouseState(&mouseX, &mouseY);
 
-        io.MousePos = ImVec2(mouseX, mouseY);
-        io.MouseDown[0] = buttons & SDL_BUTTON(SDL_BUTTON_LEFT);
-        io.MouseDown[1] = buttons & SDL_BUTTON(SDL_BUTTON_RIGHT);
+            io.MousePos = ImVec2(mouseX, mouseY);
+            io.MouseDown[0] = buttons & SDL_BUTTON(SDL_BUTTON_LEFT);
+            io.MouseDown[1] = buttons & SDL_BUTTON(SDL_BUTTON_RIGHT);
+        }
 
         // Handle core SDL events
         switch(sdlEvent.type){
@@ -110,101 +172,352 @@ void Game::ProcessInput(){
                 }
                 if (sdlEvent.key.keysym.sym == SDLK_F1){
                     isDebug = !isDebug;
+                    if (isDebug && !isImGuiInitialized) InitializeImGui();
                 }
-                eventBus -> EmitEvent<KeyPressedEvent>(SDL_GetKeyName(sdlEvent.key.keysym.sym)); 
+                if (sdlEvent.key.keysym.sym == SDLK_F2){
+                    ToggleCapture();
+                }
+                // During a replay the game only takes its input from the journal
+                if (inputJournal.IsReplaying()) break;
+                pendingInput.push_back({0, JOURNAL_KEY_DOWN, static_cast<uint64_t>(sdlEvent.key.keysym.sym)});
                 break; 
+            // Chunk textures are render targets, their contents (or the textures) go with the device
+            case SDL_RENDER_TARGETS_RESET:
+                tileLayer -> InvalidateChunks();
+                break;
+            case SDL_RENDER_DEVICE_RESET:
+                tileLayer -> ReleaseChunks();
+                break;
             case SDL_KEYUP:
-               eventBus -> EmitEvent<KeyReleasedEvent>(SDL_GetKeyName(sdlEvent.key.keysym.sym));
+               if (inputJournal.IsReplaying()) break;
+               pendingInput.push_back({0, JOURNAL_KEY_UP, static_cast<uint64_t>(sdlEvent.key.keysym.sym)});
                break;
         }
     }
 }
 
+void Game::DispatchInput(){
+    for (auto& key: pendingInput) {
+        inputJournal.Record(frameNumber, key.type, key.value);
+        const char* keyName = SDL_GetKeyName(static_cast<SDL_Keycode>(key.value));
+        if (key.type == JOURNAL_KEY_DOWN) eventBus -> EmitEvent<KeyPressedEvent>(keyName);
+        else eventBus -> EmitEvent<KeyReleasedEvent>(keyName);
+    }
+    pendingInput.clear();
+
+    // Keys recorded for this frame, in the order they were pressed
+    JournalRecord record;
+    while (inputJournal.NextRecord(frameNumber, JOURNAL_KEY_DOWN, record) || inputJournal.NextRecord(frameNumber, JOURNAL_KEY_UP, record)) {
+        const char* keyName = SDL_GetKeyName(static_cast<SDL_Keycode>(record.value));
+        if (record.type == JOURNAL_KEY_DOWN) eventBus -> EmitEvent<KeyPressedEvent>(keyName);
+        else eventBus -> EmitEvent<KeyReleasedEvent>(keyName);
+    }
+}
+
+void Game::InitializeImGui(){
+    ImGui::CreateContext();
+    ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
+    ImGui_ImplSDLRenderer2_Init(renderer);
+    isImGuiInitialized = true;
+}
+
 void Game::Setup(){
-    // Add the systems that need to be processed in our game
-    registry -> AddSystem<KeyboardMovementSystem>();
-    registry -> AddSystem<ProjectileEmitSystem>();
-    registry -> AddSystem<RenderColliderSystem>();
-    registry -> AddSystem<CameraMovementSystem>();
-    registry -> AddSystem<RenderHealthSystem>();
-    registry -> AddSystem<RenderTextSystem>();
-    registry -> AddSystem<RenderGUISystem>();
-    registry -> AddSystem<AnimationSystem>();
-    registry -> AddSystem<CollisionSystem>();
-    registry -> AddSystem<LifecycleSystem>();
-    registry -> AddSystem<MovementSystem>();
-    registry -> AddSystem<RenderSystem>();
-    registry -> AddSystem<DamageSystem>();
+    GameSystems::Add(registry);
+    // Components created while loading read the game clock
+    clock.MakeCurrent();
+    clock.SetTicks(IsFixedStep() ? 0 : SDL_GetTicks());
     
+    {
+        StartupPhase phase("level_boot_wait");
+        try {
+            levelBootTask.get();
+        } catch (const std::exception& exception) {
+            // Whatever was read is incomplete: load the level as if its script had failed
+            levelBoot.isScriptLoaded = false;
+            levelBoot.error = exception.what();
+            for (auto& surface: levelBoot.textureSurfaces) SDL_FreeSurface(surface.second);
+            levelBoot.textureSurfaces.clear();
+        }
+    }
+
+    if (IsFixedStep()) {
+        // Scripts get the same random numbers on every replay of the session
+        uint32_t seed = inputJournal.IsReplaying() ? inputJournal.GetHeader().seed : config.seed;
+        // Golden frames need the same seed on every run
+        if (seed == 0) seed = config.isHeadlessRender ? 1 : SDL_GetPerformanceCounter() & 0x7fffffff;
+        sol::function randomSeed = lua["math"]["randomseed"];
+        randomSeed(seed);
+
+        if (!config.recordPath.empty()) {
+            JournalHeader header;
+            header.seed = seed;
+            header.stepMilliseconds = MS_PER_FRAME;
+            header.level = levelNumber;
+            inputJournal.StartRecording(config.recordPath, header);
+        }
+    }
+
+    // Behaviour scripts run every frame: ScriptSystem steps the GC within its budget instead
+    LuaBindings::Register(lua, registry);
+    lua_gc(lua.lua_state(), LUA_GCSTOP, 0);
+    registry -> GetSystem<ScriptSystem>().SetGCStepKilobytes(config.luaGCStepKilobytes);
+
     // Load the first level
+    StartupPhase phase("level_load");
     LevelLoader loader;
-    lua.open_libraries(sol::lib::base, sol::lib::math);
-    loader.LoadLevel(lua, registry, assetStore, renderer, 1);
+    loader.LoadLevel(lua, registry, assetStore, navGrid, tileLayer, renderer, levelNumber, &levelBoot);
+    replayStartCounter = SDL_GetPerformanceCounter();
 }
 
-void Game::Update(){
-    // Comment the following two lines out if you want to uncap the framerate
-    int timeToWait = MS_PER_FRAME - (SDL_GetTicks() - millisecsPreviousFrame);
-    if (timeToWait > 0 && timeToWait <= MS_PER_FRAME) SDL_Delay(timeToWait);
+bool Game::IsFixedStep() const {
+    return !config.recordPath.empty() || inputJournal.IsReplaying() || config.isHeadlessRender;
+}
+
+void Game::CheckReplayFrame(){
+    uint64_t hash = HashWorld(registry);
+    if (inputJournal.IsRecording()) inputJournal.Record(frameNumber, JOURNAL_STATE_HASH, hash);
+    if (!inputJournal.IsReplaying()) return;
+
+    JournalRecord record;
+    if (inputJournal.NextRecord(frameNumber, JOURNAL_STATE_HASH, record) && record.value != hash) {
+        if (numDivergedFrames == 0) Logger::Err("Replay diverged from the recording at frame {}", frameNumber);
+        numDivergedFrames++;
+    }
+
+    if (frameNumber < inputJournal.GetLastFrame()) return;
+    double seconds = (SDL_GetPerformanceCounter() - replayStartCounter) / static_cast<double>(SDL_GetPerformanceFrequency());
+    char line[160];
+    snprintf(line, sizeof(line), "Replay finished: %u frames in %.2f s (%.3f ms/frame), %d diverged frames", frameNumber, seconds, seconds * 1000.0 / std::max(frameNumber, 1u), numDivergedFrames);
+    if (numDivergedFrames > 0) Logger::Err(line);
+    else Logger::Log(line);
+    isRunning = false;
+}
+
+void Game::BeginFrame(){
+    if (!config.isUncapped) {
+        int timeToWait = MS_PER_FRAME - (SDL_GetTicks() - millisecsPreviousFrame);
+        if (timeToWait > 0 && timeToWait <= MS_PER_FRAME) SDL_Delay(timeToWait);
+    }
     
     // Difference in ticks since last frame, converted to seconds
-    double deltaTime = (SDL_GetTicks() - millisecsPreviousFrame) / 1000.0;
+    frameDeltaTime = (SDL_GetTicks() - millisecsPreviousFrame) / 1000.0;
     
     millisecsPreviousFrame = SDL_GetTicks();
+    frameStartCounter = SDL_GetPerformanceCounter();
+}
+
+void Game::Update(){
+    double deltaTime = frameDeltaTime;
+    frameNumber++;
     
-    // Reset all event handlers for current frame
-    eventBus -> Reset();
-
-    // Perform subscription events for all systems
-    registry -> GetSystem<KeyboardMovementSystem>().SubscribeToEvents(eventBus); 
-    registry -> GetSystem<ProjectileEmitSystem>().SubscribeToEvents(eventBus);
-    registry -> GetSystem<MovementSystem>().SubscribeToEvents(eventBus);
-    registry -> GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
-    
-    // Invoke all systems that need to update
-    registry -> GetSystem<CameraMovementSystem>().Update(camera);
-    registry -> GetSystem<ProjectileEmitSystem>().Update(registry);
-    registry -> GetSystem<CollisionSystem>().Update(eventBus);
-    registry -> GetSystem<MovementSystem>().Update(deltaTime);
-    registry -> GetSystem<LifecycleSystem>().Update();
-    registry -> GetSystem<AnimationSystem>().Update();
-    
-    // Update the registry to process entities that are waiting to be created/deleted
-    registry -> Update(); 
+    if (IsFixedStep()) {
+        // Recorded and replayed sessions advance by exactly one frame, however long it really took
+        clock.Advance(MS_PER_FRAME);
+        deltaTime = MS_PER_FRAME / 1000.0;
+    } else {
+        clock.SetTicks(millisecsPreviousFrame);
+    }
+
+    GameSystems::Update(registry, eventBus, navGrid, camera, lua, deltaTime);
+    if (IsFixedStep()) CheckReplayFrame();
+    registry -> PublishTelemetry();
+    FrameArena::Current().Reset();
+}
+
+void Game::SimulateFrame(){
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+    DispatchInput();
+    Update();
+    if (!config.isHeadless) CaptureSnapshot(snapshots[1 - drawnSnapshot]);
+    simulationMilliseconds = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void Game::CaptureSnapshot(RenderSnapshot& snapshot){
+    snapshot.Clear();
+    snapshot.frameNumber = frameNumber;
+    snapshot.camera = camera;
+    registry -> GetSystem<RenderSystem>().Capture(snapshot, camera);
+    registry -> GetSystem<RenderTextSystem>().Capture(snapshot, camera);
+    registry -> GetSystem<RenderHealthSystem>().Capture(snapshot, camera);
+    registry -> GetSystem<ParticleSystem>().Capture(snapshot, camera);
+}
+
+void Game::SwapSnapshots(){
+    drawnSnapshot = 1 - drawnSnapshot;
 }
 
 void Game::Render(){
+    const RenderSnapshot& snapshot = snapshots[drawnSnapshot];
+    // The headless replay has no snapshots, it goes by the simulation's frame
+    uint32_t renderedFrame = config.isHeadless ? frameNumber : snapshot.frameNumber;
+    if (!config.isHeadless) {
+        Uint64 renderStartCounter = SDL_GetPerformanceCounter();
+        RenderFrame(snapshot);
+        renderMilliseconds += (SDL_GetPerformanceCounter() - renderStartCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    }
+    if (goldenFrames) goldenFrames -> CheckFrame(renderedFrame, renderSurface);
+    if (config.frameLimit > 0 && renderedFrame >= config.frameLimit && isRunning) {
+        double seconds = (SDL_GetPerformanceCounter() - replayStartCounter) / static_cast<double>(SDL_GetPerformanceFrequency());
+        Logger::Log("Stopped after {} frames: {} ms/frame, {} ms/frame rendering, {} ms/frame of simulation overlapped with rendering", renderedFrame, seconds * 1000.0 / renderedFrame, renderMilliseconds / renderedFrame, overlapMilliseconds / renderedFrame);
+        isRunning = false;
+    }
+
+    // Frame time as seen by the player, excluding the wait for the frame cap
+    double frameTime = (SDL_GetPerformanceCounter() - frameStartCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    if (dynamicResolution) dynamicResolution -> RecordFrameTime(frameTime);
+
+    Telemetry::Set(TELEMETRY_FRAME_NUMBER, renderedFrame);
+    Telemetry::Set(TELEMETRY_FRAME_TIME_US, frameTime * 1000);
+    Telemetry::Publish();
+    AllocationTracker::EndFrame();
+    FrameArena::Current().Reset();
+}
+
+void Game::RenderFrame(const RenderSnapshot& snapshot){
     SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
     SDL_RenderClear(renderer);
         
     // Invoke all systems that need to render
-    registry -> GetSystem<RenderSystem>().Update(renderer, assetStore, camera);
-    registry -> GetSystem<RenderTextSystem>().Update(renderer, assetStore, camera);
-    registry -> GetSystem<RenderHealthSystem>().Update(renderer, assetStore, camera);
+    SDL_Rect snapshotCamera = snapshot.camera;
+    AllocationScope scope;
+    if (dynamicResolution) {
+        // The world goes through the scaled offscreen target, fixed sprites and labels stay at native resolution
+        dynamicResolution -> BeginWorld();
+        scope.Enter("TileLayer");
+        tileLayer -> Render(renderer, snapshot.camera);
+        scope.Enter("ParticleSystem");
+        registry -> GetSystem<ParticleSystem>().Draw(registry -> GetSystem<RenderSystem>().GetBatcher(), assetStore, snapshot);
+        scope.Enter("RenderSystem");
+        registry -> GetSystem<RenderSystem>().Update(renderer, assetStore, snapshot, RENDER_WORLD);
+        scope.Enter("RenderTextSystem");
+        registry -> GetSystem<RenderTextSystem>().Update(renderer, assetStore, snapshot, RENDER_WORLD);
+        scope.Enter("RenderHealthSystem");
+        registry -> GetSystem<RenderHealthSystem>().Update(renderer, assetStore, snapshot);
+        scope.Enter("RenderColliderSystem");
+        if (isDebug) registry -> GetSystem<RenderColliderSystem>().Update(renderer, snapshotCamera);
+        dynamicResolution -> EndWorld();
+
+        scope.Enter("RenderSystem");
+        registry -> GetSystem<RenderSystem>().Update(renderer, assetStore, snapshot, RENDER_FIXED);
+        scope.Enter("RenderTextSystem");
+        registry -> GetSystem<RenderTextSystem>().Update(renderer, assetStore, snapshot, RENDER_FIXED);
+    } else {
+        scope.Enter("TileLayer");
+        tileLayer -> Render(renderer, snapshot.camera);
+        scope.Enter("ParticleSystem");
+        registry -> GetSystem<ParticleSystem>().Draw(registry -> GetSystem<RenderSystem>().GetBatcher(), assetStore, snapshot);
+        scope.Enter("RenderSystem");
+        registry -> GetSystem<RenderSystem>().Update(renderer, assetStore, snapshot);
+        scope.Enter("RenderTextSystem");
+        registry -> GetSystem<RenderTextSystem>().Update(renderer, assetStore, snapshot);
+        scope.Enter("RenderHealthSystem");
+        registry -> GetSystem<RenderHealthSystem>().Update(renderer, assetStore, snapshot);
+        scope.Enter("RenderColliderSystem");
+        if (isDebug) registry -> GetSystem<RenderColliderSystem>().Update(renderer, snapshotCamera);
+    }
     if (isDebug){
-        registry -> GetSystem<RenderColliderSystem>().Update(renderer, camera);
-        
-        registry -> GetSystem<RenderGUISystem>().Update(registry);
         // Start the ImGui frame
+        scope.Enter("RenderGUISystem");
+        registry -> GetSystem<RenderGUISystem>().Update(registry);
     } 
+    scope.Enter("FrameCapture");
+    // Grab the finished frame before it is presented
+    frameCapture -> CaptureFrame(snapshot.frameNumber);
     SDL_RenderPresent(renderer);
+    if (isFirstFrame) {
+        isFirstFrame = false;
+        StartupTimeline::MarkFirstFrame();
+        Telemetry::Set(TELEMETRY_TIME_TO_FIRST_FRAME_US, StartupTimeline::GetTimeToFirstFrame() * 1000);
+    }
 }
 
 void Game::Run(){
+    // Initialize failed: don't load the level just to quit
+    if (!isRunning) {
+        if (levelBootTask.valid()) levelBootTask.wait();
+        return;
+    }
     Setup();
+    // From here on the worker owns the simulation: registry, Lua state, event bus and journal
+    bool isPipelined = config.isPipelined && !config.isHeadless;
+    if (isPipelined) {
+        simulationWorker.Start([this]() {
+            clock.MakeCurrent();
+            SimulateFrame();
+        });
+    }
+
     while(isRunning){
         ProcessInput();
-        Update();
+        BeginFrame();
+
+        // The debug view reads live components and the collider boxes, so it runs frames one after the other
+        if (!isPipelined || isDebug) {
+            SimulateFrame();
+            SwapSnapshots();
+            isPipelineFilled = false;
+            Render();
+            Telemetry::Set(TELEMETRY_SIMULATION_TIME_US, simulationMilliseconds * 1000);
+            Telemetry::Set(TELEMETRY_PIPELINE_OVERLAP_US, 0);
+            continue;
+        }
+
+        // Simulate one frame ahead, so there is always a finished snapshot to draw
+        if (!isPipelineFilled) {
+            simulationWorker.Kick();
+            simulationWorker.Wait();
+            SwapSnapshots();
+            isPipelineFilled = true;
+            continue;
+        }
+
+        // Frame N+1 is simulated on the worker while frame N is drawn here
+        Uint64 startCounter = SDL_GetPerformanceCounter();
+        simulationWorker.Kick();
+        Uint64 renderStartCounter = SDL_GetPerformanceCounter();
         Render();
+        double renderTime = (SDL_GetPerformanceCounter() - renderStartCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+        simulationWorker.Wait();
+        SwapSnapshots();
+
+        // Time both threads were busy at once: what running them serially would have added
+        double wallTime = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+        double overlap = std::max(simulationMilliseconds + renderTime - wallTime, 0.0);
+        overlapMilliseconds += overlap;
+        Telemetry::Set(TELEMETRY_SIMULATION_TIME_US, simulationMilliseconds * 1000);
+        Telemetry::Set(TELEMETRY_PIPELINE_OVERLAP_US, overlap * 1000);
     }
+    simulationWorker.Stop();
+}
+
+void Game::ToggleCapture(){
+    if (frameCapture -> IsRecording()) {
+        frameCapture -> Stop();
+        return;
+    }
+
+    std::string path = config.capturePath;
+    if (path.empty()) path = config.captureFormat == "png" ? "./captures" : "./captures/session." + config.captureFormat;
+    if (path.rfind("./captures", 0) == 0) std::filesystem::create_directories("./captures");
+    frameCapture -> Start(renderer, path, config.capturePoolSize);
 }
 
 void Game::Destroy(){
-   ImGui_ImplSDLRenderer2_Shutdown();
-   ImGui_ImplSDL2_Shutdown();
-   ImGui::DestroyContext();
+   if (goldenFrames && !goldenFrames -> Finish()) exitCode = 1;
+   frameCapture -> Stop();
+   inputJournal.Stop();
+   Telemetry::Close();
+   dynamicResolution.reset();
+   tileLayer -> ReleaseChunks();
+
+   if (isImGuiInitialized) {
+       ImGui_ImplSDLRenderer2_Shutdown();
+       ImGui_ImplSDL2_Shutdown();
+       ImGui::DestroyContext();
+   }
 
    SDL_DestroyRenderer(renderer);
+   if (renderSurface) SDL_FreeSurface(renderSurface);
    SDL_DestroyWindow(window);
    SDL_Quit(); 
 }
@@ -1,40 +1,116 @@
 #pragma once
 
+#include <atomic>
+#include <future>
+#include <vector>
 #include <sol/sol.hpp>
 #include <SDL2/SDL.h>
 
 #include "../AssetStore/AssetStore.h"
 #include "../EventBus/EventBus.h"
+#include "../Navigation/NavGrid.h"
 #include "../ECS/ECS.h"
+#include "../Renderer/DynamicResolution.h"
+#include "../Renderer/TileLayer.h"
+#include "../Renderer/RenderSnapshot.h"
+#include "../Capture/FrameCapture.h"
+#include "../Capture/GoldenFrames.h"
+#include "./GameConfig.h"
+#include "./LevelLoader.h"
+#include "./FrameWorker.h"
+#include "../Clock/Clock.h"
+#include "../Replay/InputJournal.h"
 
 const int FPS = 60;
 const int MS_PER_FRAME = 1000 / FPS;
 
 class Game {
     private:
-        bool isRunning;
+        // Cleared by the main thread (quit, frame limit) or the simulation thread (end of a replay)
+        std::atomic<bool> isRunning;
         bool isDebug;
+        // ImGui is only created the first time the debug view is opened
+        bool isImGuiInitialized = false;
+        bool isFirstFrame = true;
         int millisecsPreviousFrame = 0;
-        SDL_Window* window;
-        SDL_Renderer* renderer;
+        // Performance counter value when the current frame's work started (after the frame cap delay)
+        Uint64 frameStartCounter = 0;
+        uint32_t frameNumber = 0;
+        // Seconds since the previous frame, measured on the main thread for the simulation step
+        double frameDeltaTime = 0.0;
+        GameConfig config;
+        SDL_Window* window = nullptr;
+        SDL_Renderer* renderer = nullptr;
+        // What the software renderer draws into with --headless-render
+        SDL_Surface* renderSurface = nullptr;
+        // Time spent in RenderFrame, for the headless render summary
+        double renderMilliseconds = 0.0;
+        int exitCode = 0;
         SDL_Rect camera;
+        Clock clock;
+        int levelNumber = 1;
+
+        // Key events polled on the main thread, handed to the next simulation step
+        std::vector<JournalRecord> pendingInput;
+
+        // The simulation fills one snapshot while the other is drawn
+        RenderSnapshot snapshots[2];
+        int drawnSnapshot = 0;
+        // The back snapshot holds a simulated frame that hasn't been drawn yet
+        bool isPipelineFilled = false;
+        FrameWorker simulationWorker;
+        // Of the last simulated frame, written by whichever thread ran it
+        double simulationMilliseconds = 0.0;
+        // Sum over pipelined frames of the time simulation and rendering ran at the same time
+        double overlapMilliseconds = 0.0;
+
+        // Recorded or replayed session; replays count the frames whose world hash differs from the recording
+        InputJournal inputJournal;
+        int numDivergedFrames = 0;
+        Uint64 replayStartCounter = 0;
         
         sol::state lua;
+        // Level script and image decode running while the window and renderer are created
+        LevelBootData levelBoot;
+        std::future<void> levelBootTask;
         
         std::unique_ptr<Registry> registry;
         std::unique_ptr<AssetStore> assetStore;
         std::unique_ptr<EventBus> eventBus;
+        std::unique_ptr<NavGrid> navGrid;
+        std::unique_ptr<TileLayer> tileLayer;
+        std::unique_ptr<DynamicResolution> dynamicResolution;
+        std::unique_ptr<FrameCapture> frameCapture;
+        std::unique_ptr<GoldenFrames> goldenFrames;
             
     public:
-        Game();
+        Game(const GameConfig& config = GameConfig());
         ~Game();
         void Initialize();
         void Run();
         void Setup();
+        // Poll SDL events on the main thread, queueing key events for the simulation
         void ProcessInput();
+        // Emit the queued and replayed key events, on the simulation thread
+        void DispatchInput();
+        // Frame cap and frame timing, on the main thread
+        void BeginFrame();
         void Update();
+        // Input, update and snapshot capture: everything the simulation thread does for one frame
+        void SimulateFrame();
+        void CaptureSnapshot(RenderSnapshot& snapshot);
+        void SwapSnapshots();
         void Render();
+        void RenderFrame(const RenderSnapshot& snapshot);
         void Destroy();
+        void ToggleCapture();
+        void InitializeImGui();
+        // Fixed simulation step and seeded scripts, used while recording or replaying
+        bool IsFixedStep() const;
+        // Record or check the world hash after the frame's update, and stop at the end of a replay
+        void CheckReplayFrame();
+        // Non-zero when rendered frames didn't match the golden file
+        int GetExitCode() const { return exitCode; }
 
         static int windowWidth;
         static int windowHeight;
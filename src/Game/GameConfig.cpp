@@ -0,0 +1,113 @@
+#include <string>
+#include <algorithm>
+#include "./GameConfig.h"
+#include "../Logger/Logger.h"
+
+GameConfig GameConfig::FromArguments(int argc, char* argv[]) {
+    GameConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        // Options that take a value read it from the next argument
+        bool hasValue = i + 1 < argc;
+
+        if (argument == "--software") {
+            config.useSoftwareRenderer = true;
+        } else if (argument == "--dynamic-resolution") {
+            config.useDynamicResolution = true;
+        } else if (argument == "--min-scale" && hasValue) {
+            config.minResolutionScale = std::stof(argv[++i]);
+        } else if (argument == "--max-scale" && hasValue) {
+            config.maxResolutionScale = std::stof(argv[++i]);
+        } else if (argument == "--target-frame-ms" && hasValue) {
+            config.targetFrameTime = std::stod(argv[++i]);
+        } else if (argument == "--capture-format" && hasValue) {
+            config.captureFormat = argv[++i];
+        } else if (argument == "--capture-path" && hasValue) {
+            config.capturePath = argv[++i];
+        } else if (argument == "--capture-pool" && hasValue) {
+            config.capturePoolSize = std::max(1, std::stoi(argv[++i]));
+        } else if (argument == "--capture-drop-oldest") {
+            config.captureDropOldest = true;
+        } else if (argument == "--telemetry") {
+            config.useTelemetry = true;
+        } else if (argument == "--track-allocations") {
+            config.trackAllocations = true;
+        } else if (argument == "--assert-zero-alloc") {
+            config.trackAllocations = true;
+            config.assertZeroAllocations = true;
+        } else if (argument == "--lua-gc-step" && hasValue) {
+            config.luaGCStepKilobytes = std::max(1, std::stoi(argv[++i]));
+        } else if (argument == "--log-file" && hasValue) {
+            config.logFile = argv[++i];
+        } else if (argument == "--record" && hasValue) {
+            config.recordPath = argv[++i];
+        } else if (argument == "--replay" && hasValue) {
+            config.replayPath = argv[++i];
+        } else if (argument == "--seed" && hasValue) {
+            config.seed = std::stoul(argv[++i]);
+        } else if (argument == "--uncapped") {
+            config.isUncapped = true;
+        } else if (argument == "--serial") {
+            config.isPipelined = false;
+        } else if (argument == "--headless") {
+            config.isHeadless = true;
+        } else if (argument == "--headless-render") {
+            config.isHeadlessRender = true;
+        } else if (argument == "--resolution" && hasValue) {
+            std::string resolution = argv[++i];
+            size_t separator = resolution.find('x');
+            if (separator != std::string::npos) {
+                config.renderWidth = std::max(1, std::stoi(resolution.substr(0, separator)));
+                config.renderHeight = std::max(1, std::stoi(resolution.substr(separator + 1)));
+            } else {
+                Logger::Warn("--resolution wants WIDTHxHEIGHT, got {}", resolution);
+            }
+        } else if (argument == "--frames" && hasValue) {
+            config.frameLimit = std::stoul(argv[++i]);
+        } else if (argument == "--golden" && hasValue) {
+            config.goldenPath = argv[++i];
+        } else if (argument == "--write-golden") {
+            config.isWritingGolden = true;
+        } else if (argument == "--golden-every" && hasValue) {
+            config.goldenEvery = std::max(1, std::stoi(argv[++i]));
+        } else {
+            Logger::Warn("Unknown command line option: {}", argument);
+        }
+    }
+
+    // Keep the scale bounds sane: positive, and min never above max
+    config.maxResolutionScale = std::clamp(config.maxResolutionScale, 0.1f, 2.0f);
+    config.minResolutionScale = std::clamp(config.minResolutionScale, 0.1f, config.maxResolutionScale);
+
+    if (!config.recordPath.empty() && !config.replayPath.empty()) {
+        Logger::Warn("Can't record and replay at the same time, ignoring --record");
+        config.recordPath.clear();
+    }
+    if (config.isHeadlessRender) {
+        if (config.isHeadless) Logger::Warn("--headless-render renders, ignoring --headless");
+        config.isHeadless = false;
+        config.isUncapped = true;
+        // Nothing else would stop it
+        if (config.frameLimit == 0 && config.replayPath.empty()) {
+            Logger::Warn("--headless-render without --frames or --replay, stopping after 600 frames");
+            config.frameLimit = 600;
+        }
+    }
+    if (!config.goldenPath.empty() && !config.isHeadlessRender) {
+        Logger::Warn("--golden needs --headless-render, ignoring it");
+        config.goldenPath.clear();
+    }
+    if (config.isWritingGolden && config.goldenPath.empty()) {
+        Logger::Warn("--write-golden needs --golden PATH, ignoring it");
+        config.isWritingGolden = false;
+    }
+
+    // Without a replay nothing would ever stop a headless run
+    if (config.isHeadless && config.replayPath.empty()) {
+        Logger::Warn("--headless needs --replay, opening a window");
+        config.isHeadless = false;
+    }
+
+    return config;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Runtime options, read from the command line
+// Example: ./engine --software --dynamic-resolution --min-scale 0.5 --max-scale 1.0
+struct GameConfig {
+    // Use SDL's software renderer instead of the default (usually accelerated) one
+    bool useSoftwareRenderer = false;
+
+    // Render the world into an offscreen target whose scale follows the measured frame time
+    bool useDynamicResolution = false;
+    float minResolutionScale = 0.5f;
+    float maxResolutionScale = 1.0f;
+    // Frame time the dynamic resolution tries to stay under, 0 = one frame at the FPS cap
+    double targetFrameTime = 0.0;
+
+    // Frame capture, toggled with F2: "qoi" or "raw" streams, or a "png" sequence
+    std::string captureFormat = "qoi";
+    // Output file for streams, or directory for png sequences (empty = ./captures/...)
+    std::string capturePath = "";
+    int capturePoolSize = 8;
+    // When the encoder falls behind, drop the oldest queued frame instead of the newest
+    bool captureDropOldest = false;
+
+    // Publish runtime counters to shared memory for the engine-telemetry reader
+    bool useTelemetry = false;
+
+    // Count heap allocations per frame and per system, shown in the debug view
+    bool trackAllocations = false;
+    // Abort when a frame allocates after the warmup frames (implies trackAllocations)
+    bool assertZeroAllocations = false;
+
+    // Input journal of a session to write, or to play back with a fixed step and world hash checks
+    std::string recordPath = "";
+    std::string replayPath = "";
+    // Lua random seed for a recording, 0 = pick one
+    uint32_t seed = 0;
+    // Run frames back to back instead of waiting for the frame cap
+    bool isUncapped = false;
+    // Simulate the next frame on a worker thread while the main thread draws the current one
+    // --serial runs them one after the other, which is easier to debug and profile
+    bool isPipelined = true;
+    // Replay without a window or any rendering (needs a replay)
+    bool isHeadless = false;
+
+    // Render with the software renderer into an offscreen surface, on the dummy video driver
+    // Runs with the fixed step and uncapped, for measuring and checking the render path without a display.
+    // Example: ./engine --headless-render --resolution 1280x720 --frames 600 --golden ./golden/level1.txt
+    bool isHeadlessRender = false;
+    int renderWidth = 1280;
+    int renderHeight = 720;
+    // Stop after this many frames, 0 = run until quit (or the end of a replay)
+    uint32_t frameLimit = 0;
+    // Golden file of frame hashes to check against, or to write with --write-golden
+    std::string goldenPath = "";
+    bool isWritingGolden = false;
+    // Hash every Kth frame
+    int goldenEvery = 1;
+
+    // Lua GC work per frame, in kilobytes of allocation
+    int luaGCStepKilobytes = 64;
+
+    // Log file, rotated as it grows (empty = console only)
+    std::string logFile = "./src/Logger/logs/session.txt";
+
+    static GameConfig FromArguments(int argc, char* argv[]);
+};
@@ -0,0 +1,83 @@
+#include "../Systems/KeyboardMovementSystem.h"
+#include "../Systems/ProjectileEmitSystem.h"
+#include "../Systems/RenderColliderSystem.h"
+#include "../Systems/CameraMovementSystem.h"
+#include "../Systems/RenderHealthSystem.h"
+#include "../Systems/RenderTextSystem.h"
+#include "../Systems/RenderGUISystem.h"
+#include "../Systems/NavigationSystem.h"
+#include "../Systems/ParticleSystem.h"
+#include "../Systems/AnimationSystem.h"
+#include "../Systems/LifecycleSystem.h"
+#include "../Systems/CollisionSystem.h"
+#include "../Systems/MovementSystem.h"
+#include "../Systems/BehaviourSystem.h"
+#include "../Systems/ScriptSystem.h"
+#include "../Systems/DamageSystem.h"
+#include "../Systems/RenderSystem.h"
+#include "../Profiler/AllocationTracker.h"
+#include "./GameSystems.h"
+
+void GameSystems::Add(const std::unique_ptr<Registry>& registry) {
+    // Add the systems that need to be processed in our game
+    registry -> AddSystem<KeyboardMovementSystem>();
+    registry -> AddSystem<ProjectileEmitSystem>();
+    registry -> AddSystem<RenderColliderSystem>();
+    registry -> AddSystem<CameraMovementSystem>();
+    registry -> AddSystem<RenderHealthSystem>();
+    registry -> AddSystem<RenderTextSystem>();
+    registry -> AddSystem<RenderGUISystem>();
+    registry -> AddSystem<NavigationSystem>();
+    registry -> AddSystem<ParticleSystem>();
+    registry -> AddSystem<AnimationSystem>();
+    registry -> AddSystem<CollisionSystem>();
+    registry -> AddSystem<LifecycleSystem>();
+    registry -> AddSystem<MovementSystem>();
+    registry -> AddSystem<ScriptSystem>();
+    registry -> AddSystem<BehaviourSystem>();
+    registry -> AddSystem<RenderSystem>();
+    registry -> AddSystem<DamageSystem>();
+}
+
+void GameSystems::Update(std::unique_ptr<Registry>& registry, std::unique_ptr<EventBus>& eventBus, const std::unique_ptr<NavGrid>& navGrid, SDL_Rect& camera, sol::state& lua, double deltaTime) {
+    // Heap allocations below are attributed to the step that made them
+    AllocationScope scope;
+
+    // Reset all event handlers for current frame
+    scope.Enter("EventBus");
+    eventBus -> Reset();
+
+    // Perform subscription events for all systems
+    registry -> GetSystem<KeyboardMovementSystem>().SubscribeToEvents(eventBus); 
+    registry -> GetSystem<ProjectileEmitSystem>().SubscribeToEvents(eventBus);
+    registry -> GetSystem<MovementSystem>().SubscribeToEvents(eventBus);
+    registry -> GetSystem<DamageSystem>().SubscribeToEvents(eventBus);
+    registry -> GetSystem<BehaviourSystem>().SubscribeToEvents(eventBus);
+    
+    // Invoke all systems that need to update
+    scope.Enter("CameraMovementSystem");
+    registry -> GetSystem<CameraMovementSystem>().Update(camera);
+    scope.Enter("ProjectileEmitSystem");
+    registry -> GetSystem<ProjectileEmitSystem>().Update(registry);
+    scope.Enter("CollisionSystem");
+    registry -> GetSystem<CollisionSystem>().Update(eventBus);
+    scope.Enter("NavigationSystem");
+    registry -> GetSystem<NavigationSystem>().Update(registry, navGrid);
+    // Scripts run before movement, so velocities they set apply this frame
+    scope.Enter("ScriptSystem");
+    registry -> GetSystem<ScriptSystem>().Update(lua, deltaTime);
+    scope.Enter("BehaviourSystem");
+    registry -> GetSystem<BehaviourSystem>().Update();
+    scope.Enter("MovementSystem");
+    registry -> GetSystem<MovementSystem>().Update(deltaTime);
+    scope.Enter("LifecycleSystem");
+    registry -> GetSystem<LifecycleSystem>().Update(registry);
+    scope.Enter("AnimationSystem");
+    registry -> GetSystem<AnimationSystem>().Update(eventBus);
+    scope.Enter("ParticleSystem");
+    registry -> GetSystem<ParticleSystem>().Update(deltaTime);
+    
+    // Update the registry to process entities that are waiting to be created/deleted
+    scope.Enter("Registry");
+    registry -> Update(); 
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <memory>
+#include <SDL2/SDL.h>
+#include <sol/sol.hpp>
+
+#include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+#include "../Navigation/NavGrid.h"
+
+// The set of systems that make up the game simulation, shared by the windowed
+// Game and the headless simulation worlds so both always run the same logic
+class GameSystems {
+    public:
+        // Add every system (simulation and rendering) to the registry
+        static void Add(const std::unique_ptr<Registry>& registry);
+        // Run one simulation step: event subscriptions, system updates, and the registry update
+        static void Update(std::unique_ptr<Registry>& registry, std::unique_ptr<EventBus>& eventBus, const std::unique_ptr<NavGrid>& navGrid, SDL_Rect& camera, sol::state& lua, double deltaTime);
+};
@@ -1,5 +1,10 @@
 #include <sol/sol.hpp>
+#include <SDL2/SDL_image.h>
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <vector>
 #include <sstream>
 #include <string>
 
@@ -13,6 +18,16 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/HealthComponent.h"
 #include "../Components/SpriteComponent.h"
+#include "../Components/NavigationComponent.h"
+#include "../Components/ScriptComponent.h"
+#include "../Components/ParticleEmitterComponent.h"
+#include "../Systems/ScriptSystem.h"
+#include "../Systems/BehaviourSystem.h"
+#include "../Systems/RenderSystem.h"
+#include "../Systems/AnimationSystem.h"
+#include "../Systems/ParticleSystem.h"
+#include "../Profiler/StartupTimeline.h"
+#include "../Scripting/ScriptCache.h"
 #include "./LevelLoader.h"
 #include "./Game.h"
 
@@ -24,13 +39,79 @@ LevelLoader::~LevelLoader(){
     
 }
 
-void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int levelNumber) {
-       
-    sol::protected_function_result script = lua.safe_script_file("./assets/scripts/Level" + std::to_string(levelNumber) + ".lua");
-    
-    if (!script.valid()){
-        sol::error err = script;
-        std::string errorMessage = err.what();
+// "loop", "ping_pong" or "once"
+static AnimationMode GetAnimationMode(const std::string& name) {
+    if (name == "ping_pong") return AnimationMode::PING_PONG;
+    if (name == "once") return AnimationMode::ONCE;
+    if (name != "loop") Logger::Warn("Unknown animation mode {}, looping", name);
+    return AnimationMode::LOOP;
+}
+
+// Clip id of a name, with a warning if there is no such clip
+static uint16_t GetAnimationClip(const AnimationLibrary& library, const std::string& name) {
+    uint16_t clip = library.GetClipId(name);
+    if (clip == NO_ANIMATION_CLIP) Logger::Warn("Unknown animation clip {}", name);
+    return clip;
+}
+
+// A { min = ..., max = ... } field, or a single number for both
+static void GetRange(const sol::table& table, const char* key, float& min, float& max) {
+    sol::object range = table[key];
+    if (range.is<float>()) {
+        min = max = range.as<float>();
+    } else if (range.is<sol::table>()) {
+        sol::table bounds = range;
+        min = bounds["min"].get_or(min);
+        max = bounds["max"].get_or(min);
+    }
+}
+
+bool LevelLoader::LoadScript(sol::state& lua, int levelNumber, std::string& error) {
+    return ScriptCache::RunFile(lua, "./assets/scripts/Level" + std::to_string(levelNumber) + ".lua", error);
+}
+
+void LevelLoader::Preload(sol::state& lua, int levelNumber, LevelBootData& boot) {
+    {
+        StartupPhase phase("level_script");
+        boot.isScriptLoaded = LoadScript(lua, levelNumber, boot.error);
+    }
+    if (!boot.isScriptLoaded) return;
+
+    StartupPhase phase("asset_decode");
+    // Read the image list first: lua can only be used from this thread
+    std::vector<std::pair<std::string, std::string>> textureFiles;
+    sol::table assets = lua["Level"]["assets"];
+    for (int i = 0; i <= static_cast<int>(assets.size()); i++){
+        sol::table asset = assets[i];
+        std::string assetType = asset["type"];
+        if (assetType == "texture") textureFiles.emplace_back(asset["id"], asset["file"]);
+    }
+
+    // Decode on one worker per core, each taking the next image until none is left
+    std::vector<SDL_Surface*> surfaces(textureFiles.size(), nullptr);
+    std::atomic<size_t> nextFile = 0;
+    auto decode = [&textureFiles, &surfaces, &nextFile]() {
+        for (size_t i = nextFile++; i < textureFiles.size(); i = nextFile++) {
+            surfaces[i] = IMG_Load(textureFiles[i].second.c_str());
+        }
+    };
+    size_t numWorkers = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), textureFiles.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < numWorkers; i++) workers.emplace_back(decode);
+    // This thread is one of the workers
+    decode();
+    for (auto& worker: workers) worker.join();
+    for (size_t i = 0; i < textureFiles.size(); i++) {
+        boot.textureSurfaces[textureFiles[i].first] = surfaces[i];
+    }
+}
+
+void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, const std::unique_ptr<NavGrid>& navGrid, const std::unique_ptr<TileLayer>& tileLayer, SDL_Renderer* renderer, int levelNumber, LevelBootData* boot) {
+    std::string errorMessage;
+    bool isScriptLoaded = boot ? boot -> isScriptLoaded : LoadScript(lua, levelNumber, errorMessage);
+    if (boot) errorMessage = boot -> error;
+
+    if (!isScriptLoaded){
         Logger::Err("Error loading the lua script: " + errorMessage); 
         return;
     }
@@ -45,16 +126,31 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
         std::string assetType = asset["type"];
         if (assetType == "texture"){
             std::string assetId = asset["id"];
-            assetStore -> AddTexture(assetId, asset["file"]);
-            Logger::Log("New texture asset loaded to asset store: " + assetId);
+            std::string file = asset["file"];
+            // Use the image decoded ahead of time when there is one
+            auto surface = boot ? boot -> textureSurfaces.find(assetId) : std::map<std::string, SDL_Surface*>::iterator();
+            if (boot && surface != boot -> textureSurfaces.end()) {
+                assetStore -> AddTexture(assetId, surface -> second, file);
+                boot -> textureSurfaces.erase(surface);
+            } else {
+                assetStore -> AddTexture(assetId, file);
+            }
+            Logger::Log("New texture asset loaded to asset store: {}", assetId);
         }
         
         if (assetType == "font"){
             std::string assetId = asset["id"];
             assetStore -> AddFont(assetId, asset["file"], asset["font_size"]);
-            Logger::Log("New font asset loaded to asset store: " + assetId);
+            Logger::Log("New font asset loaded to asset store: {}", assetId);
         }
     }
+    // Images decoded for ids the loop didn't take
+    if (boot) {
+        for (auto& surface: boot -> textureSurfaces) SDL_FreeSurface(surface.second);
+        boot -> textureSurfaces.clear();
+    }
+    // Every texture of the level goes into the same atlas pages
+    assetStore -> PackTextures();
 
     // Create a 2D tilemap vector
     sol::table tilemap = level["tilemap"];
@@ -82,29 +178,131 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
     int tileSize = tilemap["tile_size"];
     double tileScale = tilemap["scale"];
     std::string tilemapTextureAssetId = tilemap["texture_asset_id"]; 
-    // Loop over the 2D tileMap vector and create a tile entity for each entry
-    for(int i = 0; i < static_cast<int>(tileMap.size()); i++){
-        for(int j = 0; j < static_cast<int>(tileMap[i].size()); j++){
-            // Define the tile locations based on the indices 
-            int tileXPos = j * tileSize * tileScale;
-            int tileYPos = i * tileSize * tileScale;
-            // Define sprite srcRect based on value
-            int tileSetRow = floor(tileMap[i][j] / tileSetWidth);
-            int tileSetColumn = (tileMap[i][j] - (tileSetRow * tileSetWidth));
-            int srcRectX = tileSize * tileSetColumn;
-            int srcRectY = tileSize * tileSetRow;
-
-            Entity tile = registry -> CreateEntity();
-            tile.Group("tiles");
-            tile.AddComponent<TransformComponent>(glm::vec2(tileXPos, tileYPos), glm::vec2(tileScale, tileScale));
-            tile.AddComponent<SpriteComponent>(tilemapTextureAssetId, tileSize, tileSize, 0, false, srcRectX, srcRectY); 
+    // The tiles never move, so they are drawn from baked chunks rather than being entities
+    tileLayer -> Load(tileMap, assetStore -> GetTexture(tilemapTextureAssetId), tileSetWidth, tileSize, tileScale);
+    
+    // Keep the tilemap around as a navigation grid, with one cell per tile
+    set<int> obstacleTiles;
+    sol::optional<sol::table> hasObstacleTiles = tilemap["obstacle_tiles"];
+    if (hasObstacleTiles != sol::nullopt) {
+        sol::table tiles = tilemap["obstacle_tiles"];
+        for (const auto& key_value_pair : tiles) {
+            obstacleTiles.insert(key_value_pair.second.as<int>());
         }
     }
-    
+    navGrid -> Build(tileMap, obstacleTiles, tileSize * tileScale);
+
     // Set the map width (in pixels) based on the number of rows and columns in the tile map
     Game::mapWidth = tileMap[0].size() * tileSize * tileScale;
     Game::mapHeight = tileMap.size() * tileSize * tileScale;
 
+    // Render layers, in draw order; levels without them get DEFAULT_RENDER_LAYERS
+    auto& renderSystem = registry -> GetSystem<RenderSystem>();
+    sol::optional<sol::table> hasRenderLayers = level["render_layers"];
+    if (hasRenderLayers != sol::nullopt) {
+        sol::table renderLayers = level["render_layers"];
+        std::vector<RenderLayer> layers;
+        for (int i = 1; i <= renderLayers.size(); i++) {
+            sol::table renderLayer = renderLayers[i];
+            std::string name = renderLayer["name"];
+            bool isYSorted = renderLayer["y_sort"].get_or(false);
+            layers.push_back({name, isYSorted, {}});
+        }
+        renderSystem.SetLayers(layers);
+    }
+
+    // Animation clips, either a strip of same sized frames or a list of frames
+    auto& animationLibrary = registry -> GetSystem<AnimationSystem>().GetLibrary();
+    sol::optional<sol::table> hasAnimations = level["animations"];
+    if (hasAnimations != sol::nullopt) {
+        sol::table animations = level["animations"];
+        for (int i = 1; i <= animations.size(); i++) {
+            sol::table animation = animations[i];
+            std::string name = animation["name"];
+            AnimationMode mode = GetAnimationMode(animation["mode"].get_or(std::string("loop")));
+
+            sol::optional<sol::table> hasStrip = animation["strip"];
+            if (hasStrip != sol::nullopt) {
+                sol::table strip = animation["strip"];
+                int x = strip["x"].get_or(0);
+                int y = strip["y"].get_or(0);
+                int width = strip["width"];
+                int height = strip["height"];
+                int count = strip["count"];
+                int duration = strip["duration"];
+                animationLibrary.AddStrip(name, mode, {x, y, width, height}, count, duration);
+                continue;
+            }
+
+            std::vector<AnimationFrame> frames;
+            sol::table frameTables = animation["frames"];
+            for (int j = 1; j <= frameTables.size(); j++) {
+                sol::table frame = frameTables[j];
+                uint16_t event = NO_ANIMATION_EVENT;
+                sol::optional<std::string> eventName = frame["event"];
+                if (eventName != sol::nullopt) event = animationLibrary.GetEventId(*eventName);
+                int x = frame["x"];
+                int y = frame["y"];
+                int width = frame["width"];
+                int height = frame["height"];
+                int duration = frame["duration"];
+                frames.push_back({{x, y, width, height}, static_cast<uint16_t>(std::clamp(duration, 1, UINT16_MAX)), event});
+            }
+            animationLibrary.AddClip(name, mode, std::move(frames));
+        }
+    }
+
+    // Particle emitters, what their particles look like and how they move; particles aren't entities
+    auto& particlePool = registry -> GetSystem<ParticleSystem>().GetPool();
+    sol::optional<sol::table> hasParticleEmitters = level["particle_emitters"];
+    if (hasParticleEmitters != sol::nullopt) {
+        sol::table particleEmitters = level["particle_emitters"];
+        for (int i = 1; i <= particleEmitters.size(); i++) {
+            sol::table emitter = particleEmitters[i];
+            ParticleEmitterDefinition definition;
+            definition.name = emitter["name"];
+            definition.assetId = emitter["texture_asset_id"];
+            sol::optional<sol::table> hasSrcRect = emitter["src_rect"];
+            if (hasSrcRect != sol::nullopt) {
+                sol::table srcRect = emitter["src_rect"];
+                definition.srcRect = {srcRect["x"].get_or(0), srcRect["y"].get_or(0), srcRect["width"].get_or(0), srcRect["height"].get_or(0)};
+            }
+            std::string layerName = emitter["layer"].get_or(std::string("air"));
+            definition.layer = std::max(renderSystem.GetLayerIndex(layerName), 0);
+            GetRange(emitter, "lifetime", definition.minLifetime, definition.maxLifetime);
+            GetRange(emitter, "speed", definition.minSpeed, definition.maxSpeed);
+            GetRange(emitter, "angle", definition.minAngle, definition.maxAngle);
+            definition.velocity = glm::vec2(emitter["velocity"]["x"].get_or(0.0f), emitter["velocity"]["y"].get_or(0.0f));
+            definition.acceleration = glm::vec2(emitter["acceleration"]["x"].get_or(0.0f), emitter["acceleration"]["y"].get_or(0.0f));
+            definition.burstCount = emitter["count"].get_or(1);
+            definition.rate = emitter["rate"].get_or(0.0f);
+
+            // Curves are lists of keys over the particle's life, time 0 at birth and 1 at death
+            sol::optional<sol::table> hasSizes = emitter["size"];
+            if (hasSizes != sol::nullopt) {
+                sol::table sizes = emitter["size"];
+                std::vector<std::pair<float, float>> keys;
+                for (int j = 1; j <= sizes.size(); j++) {
+                    sol::table key = sizes[j];
+                    keys.emplace_back(key["time"].get_or(0.0f), key["value"].get_or(1.0f));
+                }
+                definition.SetSizeCurve(std::move(keys));
+            }
+            sol::optional<sol::table> hasColors = emitter["color"];
+            if (hasColors != sol::nullopt) {
+                sol::table colors = emitter["color"];
+                std::vector<std::pair<float, SDL_Color>> keys;
+                for (int j = 1; j <= colors.size(); j++) {
+                    sol::table key = colors[j];
+                    SDL_Color color = {key["r"].get_or<Uint8>(255), key["g"].get_or<Uint8>(255), key["b"].get_or<Uint8>(255), key["a"].get_or<Uint8>(255)};
+                    keys.emplace_back(key["time"].get_or(0.0f), color);
+                }
+                definition.SetColorCurve(std::move(keys));
+            }
+            particlePool.AddDefinition(definition);
+        }
+    }
+
     // Create entities and add components
     sol::table entities = level["entities"];
     // Loop over entities table
@@ -121,6 +319,9 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
         sol::optional<std::string> group = entity["group"];
         if (group != sol::nullopt) newEntity.Group(entity["group"]);
 
+        // Animations given as a frame count and rate, made into a strip clip once the sprite is known
+        sol::optional<sol::table> stripAnimation;
+
         // Components
         sol::optional<sol::table> hasComponents = entity["components"];
         if (hasComponents != sol::nullopt) {
@@ -158,23 +359,53 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
                     std::string assetId = component["texture_asset_id"];
                     int width = component["width"];
                     int height = component["height"];
-                    int zIndex = component["z_index"].get_or(1);
+                    // A layer name, or the index of one in older levels
+                    int layer = component["z_index"].get_or(1);
+                    sol::optional<std::string> layerName = component["layer"];
+                    if (layerName != sol::nullopt) {
+                        layer = renderSystem.GetLayerIndex(*layerName);
+                        if (layer < 0) Logger::Warn("Unknown render layer {}, using the first one", *layerName);
+                    }
                     bool isFixed = component["fixed"].get_or(false);
                     int srcRectX = component["src_rect_x"].get_or(0);                    
                     int srcRectY = component["src_rect_y"].get_or(0);
 
-                    newEntity.AddComponent<SpriteComponent>(assetId, width, height, zIndex, isFixed, srcRectX, srcRectY);                                  
-                    Logger::Log("Added sprite component to entity " + assetId);
+                    newEntity.AddComponent<SpriteComponent>(assetId, width, height, layer, isFixed, srcRectX, srcRectY);                                  
+                    Logger::Log("Added sprite component to entity {}", assetId);
                 }
                
                 if (componentName == "animation") {
-                    int numFrames = component["num_frames"];
-                    int frameRateSpeed = component["speed_rate"];
-                    bool isLoop = component["is_loop"].get_or(false);
+                    sol::optional<std::string> clipName = component["clip"];
+                    if (clipName == sol::nullopt) {
+                        stripAnimation = component;
+                        continue;
+                    }
 
-                    newEntity.AddComponent<AnimationComponent>(numFrames, frameRateSpeed, isLoop);
+                    AnimationComponent animation(GetAnimationClip(animationLibrary, *clipName));
+                    sol::optional<sol::table> hasFacing = component["facing"];
+                    if (hasFacing != sol::nullopt) {
+                        const char* facingNames[NUM_FACINGS] = {"up", "right", "down", "left"};
+                        for (int facing = 0; facing < NUM_FACINGS; facing++) {
+                            sol::optional<std::string> facingClip = component["facing"][facingNames[facing]];
+                            if (facingClip != sol::nullopt) animation.facingClips[facing] = GetAnimationClip(animationLibrary, *facingClip);
+                        }
+                    }
+                    newEntity.AddComponent<AnimationComponent>(animation);
                 }
                
+                if (componentName == "particles") {
+                    std::string name = component["emitter"];
+                    int definition = particlePool.GetDefinitionId(name);
+                    if (definition < 0) {
+                        Logger::Warn("Unknown particle emitter {}", name);
+                        continue;
+                    }
+                    glm::vec2 offset = glm::vec2(component["offset"]["x"].get_or(0.0f), component["offset"]["y"].get_or(0.0f));
+                    float rate = component["rate"].get_or(particlePool.GetDefinition(definition).rate);
+                    bool isEmitting = component["is_emitting"].get_or(true);
+                    newEntity.AddComponent<ParticleEmitterComponent>(definition, offset, rate, isEmitting);
+                }
+
                 if (componentName == "boxcollider") {
                     int width = component["width"];
                     int height = component["height"];
@@ -187,6 +418,36 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
                     newEntity.AddComponent<BoxColliderComponent>(width, height, damageLayer, offset);
                 }
                
+                if (componentName == "script") {
+                    // on_update is a function of the level script, or the name of a global one
+                    sol::object onUpdate = component["on_update"];
+                    std::string name = component["name"].get_or(std::string("script"));
+                    sol::object function = onUpdate;
+                    if (onUpdate.is<std::string>()) {
+                        name = onUpdate.as<std::string>();
+                        function = lua[name];
+                    }
+
+                    if (function.is<sol::protected_function>()) {
+                        int scriptId = registry -> GetSystem<ScriptSystem>().AddScript(lua, name, function.as<sol::protected_function>());
+                        newEntity.AddComponent<ScriptComponent>(scriptId);
+                    } else {
+                        Logger::Err("Script component without an on_update function: {}", name);
+                    }
+                }
+
+                if (componentName == "behaviour") {
+                    // run is a function of the level script, or the name of a global one
+                    sol::object run = component["run"];
+                    if (run.is<std::string>()) run = lua[run.as<std::string>()];
+
+                    if (run.is<sol::function>()) {
+                        registry -> GetSystem<BehaviourSystem>().Start(run.as<sol::function>(), registry -> GetHandle(newEntity));
+                    } else {
+                        Logger::Err("Behaviour component without a run function");
+                    }
+                }
+
                 if (componentName == "health") {
                     int healthPercentage = component["health_percentage"];
                     newEntity.AddComponent<HealthComponent>(healthPercentage);
@@ -202,8 +463,9 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
                     int projectileDamage = component["hit_percentage_damage"].get_or(10);
                     int projectileDamageLayer = component["projectile_damage_layer"];
                     bool isAuto = component["is_auto"].get_or(true);
+                    int projectilePoolSize = component["pool_size"].get_or(DEFAULT_PROJECTILE_POOL_SIZE);
 
-                    newEntity.AddComponent<ProjectileEmitterComponent>(projectileVelocity, projectileFrequency, projectileDuration, projectileDamage, projectileDamageLayer, isAuto);
+                    newEntity.AddComponent<ProjectileEmitterComponent>(projectileVelocity, projectileFrequency, projectileDuration, projectileDamage, projectileDamageLayer, isAuto, projectilePoolSize);
                 }
                
                 if (componentName == "keyboard_controller") {
@@ -214,7 +476,42 @@ void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& re
                 if (componentName == "camera_follow") {
                     newEntity.AddComponent<CameraFollowComponent>();
                 }
+
+                if (componentName == "navigation") {
+                    int speed = component["speed"];
+                    std::string targetTag = component["target"].get_or(std::string("player"));
+                    newEntity.AddComponent<NavigationComponent>(speed, targetTag);
+                }
+            }
+        }
+
+        // Strip animations always looped on the sprite's row, and keyboard controlled sprites
+        // switched to the row of the direction they face
+        if (stripAnimation != sol::nullopt && newEntity.HasComponent<SpriteComponent>()) {
+            const auto sprite = newEntity.GetComponent<SpriteComponent>();
+            int numFrames = (*stripAnimation)["num_frames"];
+            int frameRateSpeed = (*stripAnimation)["speed_rate"];
+            int duration = 1000 / std::max(frameRateSpeed, 1);
+            SDL_Rect firstRect = {sprite.srcRect.x, sprite.srcRect.y, sprite.width, sprite.height};
+
+            AnimationComponent animation(animationLibrary.AddStrip("", AnimationMode::LOOP, firstRect, numFrames, duration));
+            if (newEntity.HasComponent<KeyboardControlComponent>()) {
+                for (int facing = 0; facing < NUM_FACINGS; facing++) {
+                    firstRect.y = sprite.height * facing;
+                    animation.facingClips[facing] = animationLibrary.AddStrip("", AnimationMode::LOOP, firstRect, numFrames, duration);
+                }
             }
+            newEntity.AddComponent<AnimationComponent>(animation);
+        }
+
+        // Obstacles block the navigation cells covered by their collider
+        if (group != sol::nullopt && group.value() == "obstacles" && newEntity.HasComponent<TransformComponent>() && newEntity.HasComponent<BoxColliderComponent>()) {
+            const auto transform = newEntity.GetComponent<TransformComponent>();
+            const auto collider = newEntity.GetComponent<BoxColliderComponent>();
+            navGrid -> BlockArea(
+                glm::vec2(transform.position.x + collider.offset.x * transform.scale.x, transform.position.y + collider.offset.y * transform.scale.y),
+                glm::vec2(collider.width * transform.scale.x, collider.height * transform.scale.y)
+            );
         }
     }
 }
@@ -2,13 +2,33 @@
 
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Navigation/NavGrid.h"
+#include "../Renderer/TileLayer.h"
 #include <SDL2/SDL.h>
 #include <sol/sol.hpp>
+#include <map>
 #include <memory>
+#include <string>
+
+// Level work done ahead of LoadLevel, possibly on another thread
+struct LevelBootData {
+    bool isScriptLoaded = false;
+    std::string error;
+    // Decoded images by asset id, turned into textures by LoadLevel
+    std::map<std::string, SDL_Surface*> textureSurfaces;
+};
 
 class LevelLoader {
     public: 
         LevelLoader();
         ~LevelLoader();
-        void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, SDL_Renderer* renderer, int level);
+
+        // Run the level script, which defines the global Level table, from the bytecode cache when it is up to date
+        static bool LoadScript(sol::state& lua, int level, std::string& error);
+        // Run the level script and decode its images in parallel
+        // Doesn't need the renderer, so it can run on a worker thread while nothing else uses lua
+        static void Preload(sol::state& lua, int level, LevelBootData& boot);
+
+        // Create the level's assets and entities; steps already done in boot are skipped
+        void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetStore>& assetStore, const std::unique_ptr<NavGrid>& navGrid, const std::unique_ptr<TileLayer>& tileLayer, SDL_Renderer* renderer, int level, LevelBootData* boot = nullptr);
 };
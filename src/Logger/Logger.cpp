@@ -1,49 +1,235 @@
 #include "Logger.h"
-#include <iostream>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <cstdio>
 #include <ctime>
-#include <fstream>
+#include <cstring>
+#include <thread>
+#include <filesystem>
 using namespace std;
 
-vector<LogEntry> Logger::messages;
+// Bounded multi-producer queue: every cell carries a sequence number telling producers and the
+// writer whose turn it is, so pushing is a compare-and-swap and a copy, without locks
+// When the ring is full producers yield until the writer frees a cell.
+struct LogCell {
+    atomic<uint64_t> sequence;
+    LogRecord record;
+};
 
-string timeStamp() {
-    time_t time = std::time({});
-    string timeString(30, '\0');
-    strftime(&timeString[0], timeString.size(), "%b %d %Y, %T", localtime(&time));
-    return timeString;
+static LogCell cells[LOG_QUEUE_SIZE];
+static atomic<uint64_t> enqueuePosition{0};
+// Records the writer has finished with
+static atomic<uint64_t> numWritten{0};
+
+static once_flag startFlag;
+static thread writerThread;
+static atomic<bool> isWriterRunning{false};
+
+static mutex fileMutex;
+static string pendingFilePath;
+static atomic<bool> hasPendingFile{false};
+
+static mutex historyMutex;
+static deque<LogEntry> history;
+
+atomic<uint64_t> Logger::numDropped{0};
+
+static const char* typeNames[] = {"INFO", "WARNING", "ERROR"};
+static const char* typeColors[] = {"\033[1;92m", "\033[1;93m", "\033[1;31m"};
+
+// Formats records and writes them out, only touched by the writer thread
+class LogWriter {
+    private:
+        FILE* file = nullptr;
+        string filePath;
+        long fileBytes = 0;
+        char line[LOG_TEXT_SIZE * 4];
+
+        // Replace each {} of the format with the next argument
+        int FormatMessage(const LogRecord& record, char* output, int size) {
+            if (!record.format) {
+                int length = min<int>(record.textLength, size - 1);
+                memcpy(output, record.text, length);
+                output[length] = '\0';
+                return length;
+            }
+
+            int length = 0;
+            int nextArg = 0;
+            for (const char* c = record.format; *c && length < size - 1; c++) {
+                if (c[0] != '{' || c[1] != '}' || nextArg == record.numArgs) {
+                    output[length++] = *c;
+                    continue;
+                }
+                c++;
+                const LogArg& arg = record.args[nextArg++];
+                int written = 0;
+                switch (arg.type) {
+                    case LOG_ARG_INT: written = snprintf(output + length, size - length, "%lld", static_cast<long long>(arg.i)); break;
+                    case LOG_ARG_UINT: written = snprintf(output + length, size - length, "%llu", static_cast<unsigned long long>(arg.u)); break;
+                    case LOG_ARG_DOUBLE: written = snprintf(output + length, size - length, "%g", arg.d); break;
+                    case LOG_ARG_TEXT: written = snprintf(output + length, size - length, "%.*s", arg.text.length, record.text + arg.text.offset); break;
+                }
+                length = min(length + max(written, 0), size - 1);
+            }
+            output[length] = '\0';
+            return length;
+        }
+
+        void OpenFile(const string& path) {
+            if (file) fclose(file);
+            filePath = path;
+            filesystem::path parent = filesystem::path(path).parent_path();
+            error_code error;
+            if (!parent.empty()) filesystem::create_directories(parent, error);
+            file = fopen(path.c_str(), "a");
+            fileBytes = file ? ftell(file) : 0;
+        }
+
+        // session.txt -> session.txt.1 -> session.txt.2 ..., dropping the oldest
+        void RotateFile() {
+            fclose(file);
+            error_code error;
+            for (int i = LOG_FILE_COUNT - 1; i >= 1; i--) {
+                string from = i == 1 ? filePath : filePath + "." + to_string(i - 1);
+                filesystem::rename(from, filePath + "." + to_string(i), error);
+            }
+            file = fopen(filePath.c_str(), "w");
+            fileBytes = 0;
+        }
+
+    public:
+        ~LogWriter() {
+            if (file) fclose(file);
+        }
+
+        void Write(const LogRecord& record) {
+            if (hasPendingFile.exchange(false)) {
+                lock_guard<mutex> lock(fileMutex);
+                OpenFile(pendingFilePath);
+            }
+
+            time_t time = chrono::system_clock::to_time_t(chrono::system_clock::time_point(chrono::system_clock::duration(record.time)));
+            tm localTime;
+            localtime_r(&time, &localTime);
+            char timeStamp[32];
+            strftime(timeStamp, sizeof(timeStamp), "%b %d %Y, %T", &localTime);
+
+            int length = snprintf(line, sizeof(line), "%s | %s - ", typeNames[record.type], timeStamp);
+            length += FormatMessage(record, line + length, sizeof(line) - length);
+
+            printf("%s%s\033[0m\n", typeColors[record.type], line);
+            if (file) {
+                fprintf(file, "%s\n", line);
+                fileBytes += length + 1;
+                if (fileBytes > LOG_FILE_MAX_BYTES) RotateFile();
+            }
+
+            lock_guard<mutex> lock(historyMutex);
+            history.push_back({record.type, string(line, length)});
+            if (history.size() > LOG_HISTORY_SIZE) history.pop_front();
+        }
+
+        void Flush() {
+            fflush(stdout);
+            if (file) fflush(file);
+        }
+};
+
+static void RunWriter() {
+    LogWriter writer;
+    uint64_t dequeuePosition = 0;
+
+    while (true) {
+        // Read the flag before draining, so records pushed before Shutdown are always written
+        bool isStopping = !isWriterRunning.load(memory_order_acquire);
+        bool hasWritten = false;
+
+        while (true) {
+            LogCell& cell = cells[dequeuePosition & (LOG_QUEUE_SIZE - 1)];
+            if (cell.sequence.load(memory_order_acquire) != dequeuePosition + 1) break;
+            writer.Write(cell.record);
+            // Hand the cell back to the producers for their next lap around the ring
+            cell.sequence.store(dequeuePosition + LOG_QUEUE_SIZE, memory_order_release);
+            dequeuePosition++;
+            hasWritten = true;
+        }
+
+        if (hasWritten) writer.Flush();
+        numWritten.store(dequeuePosition, memory_order_release);
+        if (isStopping) break;
+        if (!hasWritten) this_thread::sleep_for(chrono::milliseconds(2));
+    }
+}
+
+static void StartWriter() {
+    call_once(startFlag, []() {
+        for (uint64_t i = 0; i < LOG_QUEUE_SIZE; i++) cells[i].sequence.store(i, memory_order_relaxed);
+        isWriterRunning.store(true, memory_order_release);
+        writerThread = thread(RunWriter);
+    });
+}
+
+// Stops the writer when the program exits without calling Shutdown
+static struct LogWriterGuard {
+    ~LogWriterGuard() { Logger::Shutdown(); }
+} logWriterGuard;
+
+int64_t Logger::Now() {
+    return chrono::system_clock::now().time_since_epoch().count();
+}
+
+void Logger::Push(const LogRecord& record) {
+    StartWriter();
+    // Nobody would write it
+    if (!isWriterRunning.load(memory_order_acquire)) {
+        numDropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    uint64_t position = enqueuePosition.load(memory_order_relaxed);
+    LogCell* cell;
+    while (true) {
+        cell = &cells[position & (LOG_QUEUE_SIZE - 1)];
+        int64_t difference = static_cast<int64_t>(cell -> sequence.load(memory_order_acquire)) - static_cast<int64_t>(position);
+        if (difference == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed)) break;
+        } else if (difference < 0) {
+            // The writer is a whole ring behind, give it time to catch up; after shutdown nobody will
+            if (!isWriterRunning.load(memory_order_relaxed)) {
+                numDropped.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+            this_thread::yield();
+            position = enqueuePosition.load(memory_order_relaxed);
+        } else {
+            position = enqueuePosition.load(memory_order_relaxed);
+        }
+    }
+
+    cell -> record = record;
+    cell -> sequence.store(position + 1, memory_order_release);
 }
 
-void Logger::Log(const std::string& message){
-    LogEntry entry;
-    entry.type = LOG_INFO;
-    entry.message = "INFO | " + timeStamp() + " - " + message;
-    cout << "\033[1;92m" << entry.message << "\033[0m\n"; 
-    messages.push_back(entry);
-    // Logger::Save(entry.message);
+void Logger::OpenFile(const string& filePath) {
+    lock_guard<mutex> lock(fileMutex);
+    pendingFilePath = filePath;
+    hasPendingFile.store(true);
 }
 
-void Logger::Warn(const std::string& message){
-    LogEntry entry;
-    entry.type = LOG_WARNING;
-    entry.message = "WARNING | " + timeStamp() + " - " + message;
-    cout << "\033[1;93m" << entry.message << "\033[0m\n";
-    messages.push_back(entry);
+void Logger::Flush() {
+    if (!isWriterRunning.load(memory_order_acquire)) return;
+    uint64_t target = enqueuePosition.load(memory_order_acquire);
+    while (numWritten.load(memory_order_acquire) < target) this_thread::sleep_for(chrono::milliseconds(1));
 }
 
-void Logger::Err(const std::string& message){
-    LogEntry entry;
-    entry.type = LOG_ERROR;
-    entry.message = "ERROR | " + timeStamp() + " - " + message;
-    cout << "\033[1;31m" << entry.message << "\033[0m\n";
-    messages.push_back(entry);
+void Logger::Shutdown() {
+    if (!isWriterRunning.exchange(false)) return;
+    writerThread.join();
 }
 
-void Logger::Save(const std::string& message){
-    ofstream logFile;
-    logFile.open("./src/Logger/logs/session.txt");
-    if (logFile.is_open()){
-        logFile << message + "\n";
-        logFile.close();
-    } 
-    else cout << "Unable to open file"; 
+void Logger::ForEachHistoryEntry(const function<void(const LogEntry&)>& function) {
+    lock_guard<mutex> lock(historyMutex);
+    for (auto& entry: history) function(entry);
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <string>
-#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <type_traits>
 
 enum LogType{
     LOG_INFO,
@@ -9,16 +14,149 @@ enum LogType{
     LOG_ERROR
 };
 
+// Messages below this level are compiled out, e.g. -DLOG_MIN_LEVEL=1 drops info messages
+// Their calls are empty, but arguments are still evaluated at the call site: pass values after
+// a format rather than building the message, so a dropped message costs nothing.
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
 struct LogEntry{
     LogType type;
     std::string message;
 };
 
+const int LOG_MAX_ARGS = 6;
+const int LOG_TEXT_SIZE = 200;
+// Records waiting for the writer thread, must be a power of two
+const int LOG_QUEUE_SIZE = 4096;
+// Formatted messages kept in memory for the debug view
+const int LOG_HISTORY_SIZE = 256;
+const long LOG_FILE_MAX_BYTES = 4 * 1024 * 1024;
+// Rotated files kept next to the log file (session.txt.1, session.txt.2, ...)
+const int LOG_FILE_COUNT = 3;
+
+enum LogArgType {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_TEXT
+};
+
+struct LogArg {
+    LogArgType type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        // Location of a string argument in the record's text
+        struct {
+            uint16_t offset;
+            uint16_t length;
+        } text;
+    };
+};
+
+// What a logging thread hands to the writer: fixed size, formatted later
+struct LogRecord {
+    LogType type;
+    // Wall clock time, in system_clock ticks
+    int64_t time;
+    // Static format string with {} placeholders, or nullptr when text holds the whole message
+    const char* format;
+    int numArgs;
+    LogArg args[LOG_MAX_ARGS];
+    // The message or the string arguments, cut off when they don't fit
+    uint16_t textLength;
+    char text[LOG_TEXT_SIZE];
+};
+
+// Asynchronous logger
+// Logging threads copy a fixed-size record into a lock-free ring; a background thread formats the
+// records, writes them to the console and a rotating log file, and keeps a short history.
+// Example:
+//     Logger::Log("Loaded {} entities in {} ms", numEntities, milliseconds);
+//     Logger::Err("Error loading the lua script: " + errorMessage);
 class Logger {
+    private:
+        static std::atomic<uint64_t> numDropped;
+
+        static void Push(const LogRecord& record);
+
+        static void AddText(LogRecord& record, std::string_view text) {
+            uint16_t length = std::min<size_t>(text.size(), LOG_TEXT_SIZE - record.textLength);
+            std::char_traits<char>::copy(record.text + record.textLength, text.data(), length);
+            record.textLength += length;
+        }
+
+        template <typename T> static void AddArg(LogRecord& record, const T& value) {
+            if (record.numArgs == LOG_MAX_ARGS) return;
+            LogArg& arg = record.args[record.numArgs++];
+            if constexpr (std::is_same_v<T, bool> || (std::is_integral_v<T> && std::is_signed_v<T>)) {
+                arg.type = LOG_ARG_INT;
+                arg.i = value;
+            } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                arg.type = LOG_ARG_UINT;
+                arg.u = static_cast<uint64_t>(value);
+            } else if constexpr (std::is_floating_point_v<T>) {
+                arg.type = LOG_ARG_DOUBLE;
+                arg.d = value;
+            } else {
+                arg.type = LOG_ARG_TEXT;
+                arg.text.offset = record.textLength;
+                AddText(record, std::string_view(value));
+                arg.text.length = record.textLength - arg.text.offset;
+            }
+        }
+
+        static int64_t Now();
+
+        template <LogType type, typename ...TArgs> static void Write(const char* format, const TArgs& ...args) {
+            if constexpr (type >= LOG_MIN_LEVEL) {
+                LogRecord record;
+                record.type = type;
+                record.time = Now();
+                record.format = format;
+                record.numArgs = 0;
+                record.textLength = 0;
+                (AddArg(record, args), ...);
+                Push(record);
+            }
+        }
+
+        template <LogType type> static void Write(std::string_view message) {
+            if constexpr (type >= LOG_MIN_LEVEL) {
+                LogRecord record;
+                record.type = type;
+                record.time = Now();
+                record.format = nullptr;
+                record.numArgs = 0;
+                record.textLength = 0;
+                AddText(record, message);
+                Push(record);
+            }
+        }
+
     public:
-        static std::vector<LogEntry> messages;
-        static void Log(const std::string& message);
-        static void Warn(const std::string& message);
-        static void Err(const std::string& message);
-        static void Save(const std::string& message);
+        // Complete messages, copied into the record right away
+        static void Log(std::string_view message) { Write<LOG_INFO>(message); }
+        static void Warn(std::string_view message) { Write<LOG_WARNING>(message); }
+        static void Err(std::string_view message) { Write<LOG_ERROR>(message); }
+
+        // Messages formatted on the writer thread, which reads the format later: it must be a string literal
+        template <typename TArg, typename ...TArgs> static void Log(const char* format, const TArg& arg, const TArgs& ...args) { Write<LOG_INFO>(format, arg, args...); }
+        template <typename TArg, typename ...TArgs> static void Warn(const char* format, const TArg& arg, const TArgs& ...args) { Write<LOG_WARNING>(format, arg, args...); }
+        template <typename TArg, typename ...TArgs> static void Err(const char* format, const TArg& arg, const TArgs& ...args) { Write<LOG_ERROR>(format, arg, args...); }
+
+        // Also write to this file, rotated when it grows past LOG_FILE_MAX_BYTES
+        static void OpenFile(const std::string& filePath);
+        // Wait until everything logged so far has been written
+        static void Flush();
+        // Write what's left and stop the writer thread
+        static void Shutdown();
+
+        // Oldest first, at most LOG_HISTORY_SIZE entries
+        static void ForEachHistoryEntry(const std::function<void(const LogEntry&)>& function);
+        // Messages lost because they were logged after Shutdown
+        static uint64_t GetNumDropped() { return numDropped.load(std::memory_order_relaxed); }
 };
@@ -1,12 +1,20 @@
 #include "./Game/Game.h"
+#include "./Profiler/StartupTimeline.h"
+#include "./Logger/Logger.h"
 
 
 int main(int argc, char* argv[]) {
-    Game game;
-
-    game.Initialize();
-    game.Run();
-    game.Destroy();    
+    StartupTimeline::Start();
+    int exitCode;
+    // The game is gone before the logger stops, so what it logs on the way out is written
+    {
+        Game game(GameConfig::FromArguments(argc, argv));
+        game.Initialize();
+        game.Run();
+        game.Destroy();
+        exitCode = game.GetExitCode();
+    }
+    Logger::Shutdown();
     
-    return 0;
+    return exitCode;
 }
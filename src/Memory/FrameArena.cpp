@@ -0,0 +1,54 @@
+#include <cstdint>
+#include <algorithm>
+#include "./FrameArena.h"
+
+FrameArena::FrameArena(size_t capacity): buffer(new std::byte[capacity]), capacity(capacity) {
+}
+
+FrameArena::~FrameArena() {
+    // Not Reset: it could grow the buffer just before it is freed
+    FreeOverflowBlocks();
+}
+
+FrameArena& FrameArena::Current() {
+    static thread_local FrameArena arena;
+    return arena;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(buffer.get());
+    uintptr_t start = (base + used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t end = start - base + bytes;
+
+    if (end <= capacity) {
+        used = end;
+        return reinterpret_cast<void*>(start);
+    }
+
+    // Out of room: take it from the heap for this frame
+    void* block = std::pmr::new_delete_resource() -> allocate(bytes, alignment);
+    overflowBlocks.push_back({block, bytes, alignment});
+    overflowBytes += bytes;
+    return block;
+}
+
+void FrameArena::FreeOverflowBlocks() {
+    for (auto& block: overflowBlocks) std::pmr::new_delete_resource() -> deallocate(block.memory, block.bytes, block.alignment);
+    overflowBlocks.clear();
+}
+
+void FrameArena::Reset() {
+    lastFrameBytes = used + overflowBytes;
+    highWaterMark = std::max(highWaterMark, lastFrameBytes);
+
+    if (!overflowBlocks.empty()) {
+        FreeOverflowBlocks();
+        numOverflowFrames++;
+
+        // Grow so that a frame like this one fits next time, leaving room for alignment padding
+        capacity = std::max(capacity * 2, highWaterMark + highWaterMark / 4);
+        buffer.reset(new std::byte[capacity]);
+    }
+    used = 0;
+    overflowBytes = 0;
+}
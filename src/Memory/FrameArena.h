@@ -0,0 +1,67 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <memory_resource>
+
+const size_t FRAME_ARENA_DEFAULT_SIZE = 256 * 1024;
+
+// Bump allocator for scratch memory that only lives until the end of the frame
+// Every thread has its own arena (FrameArena::Current()); the owner of the thread resets it once per frame.
+// Allocations that don't fit go to the heap and the arena grows to the high-water mark on the next reset,
+// so after a few frames the scratch memory comes without any heap traffic.
+// Example:
+//     std::pmr::vector<Entity> entities(&FrameArena::Current());
+class FrameArena: public std::pmr::memory_resource {
+    private:
+        std::unique_ptr<std::byte[]> buffer;
+        size_t capacity;
+        size_t used = 0;
+        // Allocations that didn't fit in the buffer this frame
+        struct OverflowBlock {
+            void* memory;
+            size_t bytes;
+            size_t alignment;
+        };
+        std::vector<OverflowBlock> overflowBlocks;
+        size_t overflowBytes = 0;
+
+        size_t highWaterMark = 0;
+        size_t lastFrameBytes = 0;
+        int numOverflowFrames = 0;
+
+        void FreeOverflowBlocks();
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        // Memory is only given back on Reset
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    public:
+        FrameArena(size_t capacity = FRAME_ARENA_DEFAULT_SIZE);
+        ~FrameArena();
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // The calling thread's arena
+        static FrameArena& Current();
+
+        // Release everything allocated since the last reset; anything still pointing into the arena is invalid
+        void Reset();
+
+        // Uninitialized scratch storage for count trivially constructible values
+        template <typename T> std::span<T> AllocateSpan(size_t count) {
+            return std::span<T>(static_cast<T*>(allocate(count * sizeof(T), alignof(T))), count);
+        }
+
+        size_t GetCapacity() const { return capacity; }
+        size_t GetUsed() const { return used + overflowBytes; }
+        // Largest number of bytes used in a single frame
+        size_t GetHighWaterMark() const { return highWaterMark; }
+        size_t GetLastFrameBytes() const { return lastFrameBytes; }
+        // Frames that needed more than the buffer and went to the heap
+        int GetNumOverflowFrames() const { return numOverflowFrames; }
+};
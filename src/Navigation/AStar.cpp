@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cstdlib>
+#include "./AStar.h"
+#include "./FlowField.h"
+
+AStar::CellRecord& AStar::GetRecord(int index) {
+    CellRecord& record = records[index];
+    // Records from a previous query are reset the first time this query touches them
+    if (record.stamp != currentStamp) {
+        record.stamp = currentStamp;
+        record.cost = UINT32_MAX;
+        record.parent = -1;
+        record.isClosed = false;
+    }
+    return record;
+}
+
+uint32_t AStar::Heuristic(glm::ivec2 a, glm::ivec2 b) {
+    // Octile distance, using the same 10/14 step costs as the flow field
+    uint32_t dx = abs(a.x - b.x);
+    uint32_t dy = abs(a.y - b.y);
+    return 10 * (dx + dy) - 6 * min(dx, dy);
+}
+
+bool AStar::FindPath(const NavGrid& grid, glm::ivec2 start, glm::ivec2 goal, vector<glm::ivec2>& path) {
+    path.clear();
+    lastExpandedCount = 0;
+    if (!grid.IsWalkable(start) || !grid.IsWalkable(goal)) return false;
+
+    if (static_cast<int>(records.size()) < grid.GetNumCells()) records.resize(grid.GetNumCells());
+    // On wrap-around, clear the stamps so stale records can't be mistaken for fresh ones
+    if (++currentStamp == 0) {
+        for (auto& record: records) record.stamp = 0;
+        currentStamp = 1;
+    }
+    openNodes.clear();
+
+    int startIndex = grid.GetIndex(start);
+    int goalIndex = grid.GetIndex(goal);
+    GetRecord(startIndex).cost = 0;
+    openNodes.push_back({Heuristic(start, goal), startIndex});
+
+    while (!openNodes.empty()) {
+        pop_heap(openNodes.begin(), openNodes.end());
+        int index = openNodes.back().index;
+        openNodes.pop_back();
+
+        CellRecord& current = GetRecord(index);
+        if (current.isClosed) continue;
+        current.isClosed = true;
+        lastExpandedCount++;
+
+        if (index == goalIndex) {
+            // Walk the parent links back to the start
+            for (int step = goalIndex; step != -1; step = records[step].parent) {
+                path.push_back(grid.GetCell(step));
+            }
+            reverse(path.begin(), path.end());
+            return true;
+        }
+
+        glm::ivec2 cell = grid.GetCell(index);
+        for (int direction = 0; direction < 8; direction++) {
+            glm::ivec2 neighbour(cell.x + FlowField::offsets[direction].x, cell.y + FlowField::offsets[direction].y);
+            if (!grid.IsWalkable(neighbour)) continue;
+
+            bool isDiagonal = direction >= 4;
+            if (isDiagonal && (!grid.IsWalkable(glm::ivec2(neighbour.x, cell.y)) || !grid.IsWalkable(glm::ivec2(cell.x, neighbour.y)))) continue;
+
+            int neighbourIndex = grid.GetIndex(neighbour);
+            CellRecord& next = GetRecord(neighbourIndex);
+            if (next.isClosed) continue;
+
+            uint32_t cost = current.cost + (isDiagonal ? 14 : 10) * grid.GetCost(neighbourIndex);
+            if (cost < next.cost) {
+                next.cost = cost;
+                next.parent = index;
+                openNodes.push_back({cost + Heuristic(neighbour, goal), neighbourIndex});
+                push_heap(openNodes.begin(), openNodes.end());
+            }
+        }
+    }
+    return false;
+}
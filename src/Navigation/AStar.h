@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "./NavGrid.h"
+
+using namespace std;
+
+// A* search for one-off path queries on a NavGrid
+// The per-cell bookkeeping and the open set live in arenas owned by the object
+// and are reused by every query: cells are lazily reset using a search stamp,
+// so a query only touches the cells it actually visits and never allocates
+// once the arenas have grown to the size of the grid.
+class AStar {
+    private:
+        struct OpenNode {
+            uint32_t priority;
+            int index;
+            bool operator <(const OpenNode& other) const { return priority > other.priority; }
+        };
+
+        struct CellRecord {
+            uint32_t stamp = 0;
+            uint32_t cost = 0;
+            int parent = -1;
+            bool isClosed = false;
+        };
+
+        vector<CellRecord> records;
+        vector<OpenNode> openNodes;
+        uint32_t currentStamp = 0;
+        int lastExpandedCount = 0;
+
+        CellRecord& GetRecord(int index);
+        static uint32_t Heuristic(glm::ivec2 a, glm::ivec2 b);
+
+    public:
+        AStar() = default;
+
+        // Find a path between two cells, written to path as a list of cells from start to goal
+        // Returns false when the goal cannot be reached
+        bool FindPath(const NavGrid& grid, glm::ivec2 start, glm::ivec2 goal, vector<glm::ivec2>& path);
+        // Number of cells expanded by the last query
+        int GetLastExpandedCount() const { return lastExpandedCount; }
+};
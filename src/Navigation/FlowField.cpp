@@ -0,0 +1,118 @@
+#include <algorithm>
+#include "./FlowField.h"
+
+const glm::ivec2 FlowField::offsets[8] = {
+    glm::ivec2(0, -1), glm::ivec2(1, 0), glm::ivec2(0, 1), glm::ivec2(-1, 0),
+    glm::ivec2(1, -1), glm::ivec2(1, 1), glm::ivec2(-1, 1), glm::ivec2(-1, -1)
+};
+
+// Step costs scaled so diagonals are ~sqrt(2) times the orthogonal cost
+const uint32_t ORTHOGONAL_COST = 10;
+const uint32_t DIAGONAL_COST = 14;
+
+FlowField::FlowField(const NavGrid& grid) {
+    this -> grid = &grid;
+}
+
+void FlowField::SetTarget(glm::ivec2 cell) {
+    if (cell == targetCell || !grid -> IsInside(cell)) return;
+    targetCell = cell;
+    // Restarting on every move would never publish a field while the target keeps moving
+    if (!isComputing) StartSearch(cell);
+}
+
+void FlowField::StartSearch(glm::ivec2 cell) {
+    searchCell = cell;
+    // Reuse the buffers of the previous search
+    pendingIntegration.assign(grid -> GetNumCells(), FLOW_UNREACHABLE);
+    openCells.clear();
+
+    int targetIndex = grid -> GetIndex(cell);
+    pendingIntegration[targetIndex] = 0;
+    openCells.push_back({0, targetIndex});
+    isComputing = true;
+}
+
+bool FlowField::Update(int cellBudget) {
+    if (!isComputing) return false;
+
+    while (!openCells.empty() && cellBudget-- > 0) {
+        pop_heap(openCells.begin(), openCells.end());
+        OpenCell current = openCells.back();
+        openCells.pop_back();
+
+        // Skip stale heap entries left behind when a cheaper path was found
+        if (current.cost != pendingIntegration[current.index]) continue;
+
+        glm::ivec2 cell = grid -> GetCell(current.index);
+        for (int direction = 0; direction < 8; direction++) {
+            glm::ivec2 neighbour(cell.x + offsets[direction].x, cell.y + offsets[direction].y);
+            if (!grid -> IsWalkable(neighbour)) continue;
+
+            // Don't cut corners around blocked cells
+            bool isDiagonal = direction >= 4;
+            if (isDiagonal && (!grid -> IsWalkable(glm::ivec2(neighbour.x, cell.y)) || !grid -> IsWalkable(glm::ivec2(cell.x, neighbour.y)))) continue;
+
+            int neighbourIndex = grid -> GetIndex(neighbour);
+            uint32_t cost = current.cost + (isDiagonal ? DIAGONAL_COST : ORTHOGONAL_COST) * grid -> GetCost(neighbourIndex);
+            if (cost < pendingIntegration[neighbourIndex]) {
+                pendingIntegration[neighbourIndex] = cost;
+                openCells.push_back({cost, neighbourIndex});
+                push_heap(openCells.begin(), openCells.end());
+            }
+        }
+    }
+
+    if (!openCells.empty()) return false;
+
+    // Search finished: publish the new field
+    integration.swap(pendingIntegration);
+    BuildDirections();
+    isComputing = false;
+    isReady = true;
+    // The target moved on during the search
+    if (targetCell != searchCell) StartSearch(targetCell);
+    return true;
+}
+
+void FlowField::Complete() {
+    // A finished search may start the one for the latest target, run that too
+    while (isComputing) Update(grid -> GetNumCells());
+}
+
+void FlowField::BuildDirections() {
+    directions.assign(grid -> GetNumCells(), FLOW_NO_DIRECTION);
+    for (int index = 0; index < grid -> GetNumCells(); index++) {
+        uint32_t best = integration[index];
+        if (best == FLOW_UNREACHABLE) continue;
+
+        glm::ivec2 cell = grid -> GetCell(index);
+        for (int direction = 0; direction < 8; direction++) {
+            glm::ivec2 neighbour(cell.x + offsets[direction].x, cell.y + offsets[direction].y);
+            if (!grid -> IsInside(neighbour)) continue;
+            if (direction >= 4 && (!grid -> IsWalkable(glm::ivec2(neighbour.x, cell.y)) || !grid -> IsWalkable(glm::ivec2(cell.x, neighbour.y)))) continue;
+
+            uint32_t value = integration[grid -> GetIndex(neighbour)];
+            if (value < best) {
+                best = value;
+                directions[index] = direction;
+            }
+        }
+    }
+}
+
+uint32_t FlowField::GetIntegration(glm::ivec2 cell) const {
+    if (!isReady || !grid -> IsInside(cell)) return FLOW_UNREACHABLE;
+    return integration[grid -> GetIndex(cell)];
+}
+
+glm::vec2 FlowField::GetDirection(glm::vec2 position) const {
+    glm::ivec2 cell = grid -> WorldToCell(position);
+    if (!isReady || !grid -> IsInside(cell)) return glm::vec2(0);
+
+    uint8_t direction = directions[grid -> GetIndex(cell)];
+    if (direction == FLOW_NO_DIRECTION) return glm::vec2(0);
+
+    glm::vec2 step(offsets[direction].x, offsets[direction].y);
+    return direction >= 4 ? step * 0.70710678f : step;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "./NavGrid.h"
+
+using namespace std;
+
+// Integration value of a cell that cannot reach the target
+const uint32_t FLOW_UNREACHABLE = UINT32_MAX;
+// Direction index of a cell without a next step (the target itself, or unreachable cells)
+const uint8_t FLOW_NO_DIRECTION = 8;
+
+// A flow field stores, for every cell of the grid, the cost to reach one target
+// and the direction of the cheapest neighbour. Any number of agents can then
+// steer towards the target with a single lookup instead of running their own search.
+//
+// When the target moves to another cell, the new field is built in the background:
+// each Update() expands at most cellBudget cells while agents keep reading the
+// previous, complete field. The new field replaces it once the search finishes.
+// A target that moves again meanwhile doesn't restart the search: only its latest
+// cell is kept, and searched for once the current search is published.
+class FlowField {
+    private:
+        struct OpenCell {
+            uint32_t cost;
+            int index;
+            // Inverted so the std heap functions keep the cheapest cell on top
+            bool operator <(const OpenCell& other) const { return cost > other.cost; }
+        };
+
+        const NavGrid* grid;
+        // Latest cell asked for
+        glm::ivec2 targetCell = glm::ivec2(-1, -1);
+        // Cell of the search in progress
+        glm::ivec2 searchCell = glm::ivec2(-1, -1);
+        bool isReady = false;
+        bool isComputing = false;
+
+        // Complete field read by agents
+        vector<uint32_t> integration;
+        vector<uint8_t> directions;
+
+        // Field being computed for searchCell
+        vector<uint32_t> pendingIntegration;
+        vector<OpenCell> openCells;
+
+        void StartSearch(glm::ivec2 cell);
+        void BuildDirections();
+
+    public:
+        FlowField(const NavGrid& grid);
+
+        // Start computing a new field if the target is in a different cell than the current one,
+        // or once the search in progress is done
+        void SetTarget(glm::ivec2 cell);
+        // Expand up to cellBudget cells of the pending search
+        // Returns true when a new field became available during this call
+        bool Update(int cellBudget);
+        // Run the pending search to completion
+        void Complete();
+
+        bool IsReady() const { return isReady; }
+        bool IsComputing() const { return isComputing; }
+        glm::ivec2 GetTargetCell() const { return targetCell; }
+
+        uint32_t GetIntegration(glm::ivec2 cell) const;
+        // Normalized direction to steer along from a world position (zero when there is no next step)
+        glm::vec2 GetDirection(glm::vec2 position) const;
+
+        // Neighbour offsets indexed by direction: 4 orthogonal then 4 diagonal
+        static const glm::ivec2 offsets[8];
+};
@@ -0,0 +1,45 @@
+#include <cmath>
+#include <algorithm>
+#include "./NavGrid.h"
+
+void NavGrid::Build(const vector<vector<int>>& tileMap, const set<int>& blockedTiles, float cellSize) {
+    this -> cellSize = cellSize;
+    height = tileMap.size();
+    width = 0;
+    for (auto& row: tileMap) width = max(width, static_cast<int>(row.size()));
+
+    // Rows shorter than the widest one are padded with blocked cells
+    costs.assign(width * height, NAV_BLOCKED);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < static_cast<int>(tileMap[y].size()); x++) {
+            bool isBlocked = blockedTiles.find(tileMap[y][x]) != blockedTiles.end();
+            costs[y * width + x] = isBlocked ? NAV_BLOCKED : 1;
+        }
+    }
+}
+
+void NavGrid::BlockArea(glm::vec2 position, glm::vec2 size) {
+    if (IsEmpty()) return;
+    glm::ivec2 min = WorldToCell(position);
+    glm::ivec2 max = WorldToCell(glm::vec2(position.x + size.x - 1, position.y + size.y - 1));
+    for (int y = std::max(min.y, 0); y <= std::min(max.y, height - 1); y++) {
+        for (int x = std::max(min.x, 0); x <= std::min(max.x, width - 1); x++) {
+            costs[y * width + x] = NAV_BLOCKED;
+        }
+    }
+}
+
+void NavGrid::SetCost(glm::ivec2 cell, uint8_t cost) {
+    if (IsInside(cell)) costs[GetIndex(cell)] = cost;
+}
+
+glm::ivec2 NavGrid::WorldToCell(glm::vec2 position) const {
+    return glm::ivec2(
+        static_cast<int>(floor(position.x / cellSize)),
+        static_cast<int>(floor(position.y / cellSize))
+    );
+}
+
+glm::vec2 NavGrid::CellToWorld(glm::ivec2 cell) const {
+    return glm::vec2((cell.x + 0.5f) * cellSize, (cell.y + 0.5f) * cellSize);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <set>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+using namespace std;
+
+// Cost of a cell that can never be entered
+const uint8_t NAV_BLOCKED = 255;
+
+// Walkability grid built from the level tilemap
+// One cell per tile, each cell storing the cost of stepping into it (1 - 254)
+class NavGrid {
+    private:
+        int width = 0;
+        int height = 0;
+        float cellSize = 1.0f;
+        vector<uint8_t> costs;
+
+    public:
+        NavGrid() = default;
+
+        // Build the grid from the tilemap read by LevelLoader
+        // Tiles listed in blockedTiles are marked as impassable
+        void Build(const vector<vector<int>>& tileMap, const set<int>& blockedTiles, float cellSize);
+        // Mark every cell overlapped by a world-space rectangle as impassable
+        void BlockArea(glm::vec2 position, glm::vec2 size);
+
+        int GetWidth() const { return width; }
+        int GetHeight() const { return height; }
+        int GetNumCells() const { return width * height; }
+        float GetCellSize() const { return cellSize; }
+        bool IsEmpty() const { return costs.empty(); }
+
+        bool IsInside(glm::ivec2 cell) const { return cell.x >= 0 && cell.y >= 0 && cell.x < width && cell.y < height; }
+        int GetIndex(glm::ivec2 cell) const { return cell.y * width + cell.x; }
+        glm::ivec2 GetCell(int index) const { return glm::ivec2(index % width, index / width); }
+
+        uint8_t GetCost(int index) const { return costs[index]; }
+        bool IsWalkable(glm::ivec2 cell) const { return IsInside(cell) && costs[GetIndex(cell)] != NAV_BLOCKED; }
+        void SetCost(glm::ivec2 cell, uint8_t cost);
+
+        // Conversions between world pixels and grid cells
+        glm::ivec2 WorldToCell(glm::vec2 position) const;
+        glm::vec2 CellToWorld(glm::ivec2 cell) const;
+};
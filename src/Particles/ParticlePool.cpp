@@ -0,0 +1,194 @@
+#include <cmath>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "./ParticlePool.h"
+
+ParticleEmitterDefinition::ParticleEmitterDefinition() {
+    std::fill(std::begin(sizes), std::end(sizes), 1.0f);
+    std::fill(std::begin(colors), std::end(colors), SDL_Color{255, 255, 255, 255});
+}
+
+// Where the sample falls between the two keys around it
+template <typename TValue, typename TLerp>
+static void BakeCurve(std::vector<std::pair<float, TValue>>& keys, TValue* samples, TLerp lerp) {
+    if (keys.empty()) return;
+    std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    size_t key = 0;
+    for (int i = 0; i < PARTICLE_CURVE_SAMPLES; i++) {
+        float time = static_cast<float>(i) / (PARTICLE_CURVE_SAMPLES - 1);
+        while (key + 1 < keys.size() && keys[key + 1].first <= time) key++;
+        if (time <= keys[key].first || key + 1 == keys.size()) {
+            samples[i] = keys[key].second;
+            continue;
+        }
+        float span = keys[key + 1].first - keys[key].first;
+        samples[i] = lerp(keys[key].second, keys[key + 1].second, (time - keys[key].first) / span);
+    }
+}
+
+void ParticleEmitterDefinition::SetSizeCurve(std::vector<std::pair<float, float>> keys) {
+    BakeCurve(keys, sizes, [](float a, float b, float t) { return a + (b - a) * t; });
+}
+
+void ParticleEmitterDefinition::SetColorCurve(std::vector<std::pair<float, SDL_Color>> keys) {
+    BakeCurve(keys, colors, [](SDL_Color a, SDL_Color b, float t) {
+        auto channel = [t](Uint8 from, Uint8 to) { return static_cast<Uint8>(std::lround(from + (to - from) * t)); };
+        return SDL_Color{channel(a.r, b.r), channel(a.g, b.g), channel(a.b, b.b), channel(a.a, b.a)};
+    });
+}
+
+uint16_t ParticlePool::AddDefinition(const ParticleEmitterDefinition& definition) {
+    auto definitionId = definitionIds.find(definition.name);
+    if (definitionId != definitionIds.end()) {
+        definitions[definitionId -> second] = definition;
+        return definitionId -> second;
+    }
+    definitions.push_back(definition);
+    definitionIds.emplace(definition.name, definitions.size() - 1);
+    return definitions.size() - 1;
+}
+
+int ParticlePool::GetDefinitionId(const std::string& name) const {
+    auto definitionId = definitionIds.find(name);
+    return definitionId != definitionIds.end() ? definitionId -> second : -1;
+}
+
+// xorshift32, particles only need to look random
+float ParticlePool::Random(float min, float max) {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return min + (max - min) * ((randomState >> 8) * (1.0f / 16777216.0f));
+}
+
+void ParticlePool::Grow() {
+    size_t size = std::min(std::max<size_t>(positionsX.size() * 2, 1024), PARTICLE_CAPACITY);
+    for (auto array: {&positionsX, &positionsY, &velocitiesX, &velocitiesY, &accelerationsX, &accelerationsY, &ages, &ageRates}) {
+        array -> resize(size, 0.0f);
+    }
+    emitters.resize(size, 0);
+}
+
+void ParticlePool::Emit(uint16_t definitionId, float x, float y, int numParticles) {
+    if (definitionId >= definitions.size()) return;
+    const ParticleEmitterDefinition& definition = definitions[definitionId];
+    for (int i = 0; i < numParticles; i++) {
+        if (count == positionsX.size()) {
+            if (count == PARTICLE_CAPACITY) return;
+            Grow();
+        }
+        float angle = Random(definition.minAngle, definition.maxAngle) * static_cast<float>(M_PI / 180.0);
+        float speed = Random(definition.minSpeed, definition.maxSpeed);
+        float lifetime = std::max(Random(definition.minLifetime, definition.maxLifetime), 0.001f);
+        positionsX[count] = x;
+        positionsY[count] = y;
+        velocitiesX[count] = definition.velocity.x + std::cos(angle) * speed;
+        velocitiesY[count] = definition.velocity.y + std::sin(angle) * speed;
+        accelerationsX[count] = definition.acceleration.x;
+        accelerationsY[count] = definition.acceleration.y;
+        ages[count] = 0.0f;
+        ageRates[count] = 1.0f / lifetime;
+        emitters[count] = definitionId;
+        count++;
+    }
+}
+
+void ParticlePool::Integrate(float deltaTime) {
+    // Whole groups of lanes: the padding past the last particle is integrated too, and never read
+    size_t end = (count + PARTICLE_LANES - 1) / PARTICLE_LANES * PARTICLE_LANES;
+    float* x = positionsX.data();
+    float* y = positionsY.data();
+    float* vx = velocitiesX.data();
+    float* vy = velocitiesY.data();
+    const float* ax = accelerationsX.data();
+    const float* ay = accelerationsY.data();
+    float* age = ages.data();
+    const float* ageRate = ageRates.data();
+#if defined(__SSE2__)
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    for (size_t i = 0; i < end; i += PARTICLE_LANES) {
+        // Semi-implicit Euler: the new velocity moves the particle
+        __m128 newVx = _mm_add_ps(_mm_loadu_ps(vx + i), _mm_mul_ps(_mm_loadu_ps(ax + i), dt));
+        __m128 newVy = _mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(_mm_loadu_ps(ay + i), dt));
+        _mm_storeu_ps(vx + i, newVx);
+        _mm_storeu_ps(vy + i, newVy);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(newVx, dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(newVy, dt)));
+        _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), _mm_mul_ps(_mm_loadu_ps(ageRate + i), dt)));
+    }
+#else
+    for (size_t i = 0; i < end; i++) {
+        vx[i] += ax[i] * deltaTime;
+        vy[i] += ay[i] * deltaTime;
+        x[i] += vx[i] * deltaTime;
+        y[i] += vy[i] * deltaTime;
+        age[i] += ageRate[i] * deltaTime;
+    }
+#endif
+}
+
+void ParticlePool::RemoveDead() {
+    for (size_t i = 0; i < count;) {
+        if (ages[i] < 1.0f) {
+            i++;
+            continue;
+        }
+        // The last particle takes the dead one's place, it is checked next
+        size_t last = --count;
+        positionsX[i] = positionsX[last];
+        positionsY[i] = positionsY[last];
+        velocitiesX[i] = velocitiesX[last];
+        velocitiesY[i] = velocitiesY[last];
+        accelerationsX[i] = accelerationsX[last];
+        accelerationsY[i] = accelerationsY[last];
+        ages[i] = ages[last];
+        ageRates[i] = ageRates[last];
+        emitters[i] = emitters[last];
+    }
+}
+
+void ParticlePool::Update(float deltaTime) {
+    if (count == 0) return;
+    Integrate(deltaTime);
+    RemoveDead();
+}
+
+void ParticlePool::Capture(RenderSnapshot& snapshot, const SDL_Rect& camera) {
+    size_t numDefinitions = definitions.size();
+    snapshot.particleRanges.assign(numDefinitions + 1, 0);
+    snapshot.particles.clear();
+    if (count == 0) return;
+
+    // Curve sample of every particle the camera sees, -1 for the others
+    captureSamples.resize(count);
+    captureCounts.assign(numDefinitions, 0);
+    const float sampleScale = PARTICLE_CURVE_SAMPLES - 1;
+    size_t numVisible = 0;
+    for (size_t i = 0; i < count; i++) {
+        int sample = std::min(static_cast<int>(ages[i] * sampleScale), PARTICLE_CURVE_SAMPLES - 1);
+        float halfSize = definitions[emitters[i]].sizes[sample] * 0.5f;
+        bool isVisible = positionsX[i] + halfSize >= camera.x && positionsX[i] - halfSize <= camera.x + camera.w &&
+            positionsY[i] + halfSize >= camera.y && positionsY[i] - halfSize <= camera.y + camera.h;
+        captureSamples[i] = isVisible ? sample : -1;
+        if (!isVisible) continue;
+        captureCounts[emitters[i]]++;
+        numVisible++;
+    }
+
+    // Counting sort by definition, so each one's particles go to the renderer in one run
+    for (size_t i = 0; i < numDefinitions; i++) snapshot.particleRanges[i + 1] = snapshot.particleRanges[i] + captureCounts[i];
+    std::copy(snapshot.particleRanges.begin(), snapshot.particleRanges.end() - 1, captureCounts.begin());
+    snapshot.particles.resize(numVisible);
+    for (size_t i = 0; i < count; i++) {
+        int sample = captureSamples[i];
+        if (sample < 0) continue;
+        const ParticleEmitterDefinition& definition = definitions[emitters[i]];
+        ParticleInstance& instance = snapshot.particles[captureCounts[emitters[i]]++];
+        instance.x = positionsX[i] - camera.x;
+        instance.y = positionsY[i] - camera.y;
+        instance.size = definition.sizes[sample];
+        instance.color = definition.colors[sample];
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <unordered_map>
+#include <glm/glm.hpp>
+#include <SDL2/SDL.h>
+#include "../Renderer/RenderSnapshot.h"
+
+// Most particles alive at once, the ones emitted past it are dropped
+const size_t PARTICLE_CAPACITY = 65536;
+// Size and color curves are sampled this many times over a particle's life
+const int PARTICLE_CURVE_SAMPLES = 32;
+// Particles integrated per SIMD step; the arrays are padded to a multiple of it
+const size_t PARTICLE_LANES = 4;
+
+// How an emitter's particles start, move, look and age, named in the level
+struct ParticleEmitterDefinition {
+    std::string name;
+    std::string assetId;
+    // Relative to the texture, empty for the whole texture
+    SDL_Rect srcRect = {0, 0, 0, 0};
+    // Render layer the particles are drawn in
+    int layer = 0;
+    // Seconds
+    float minLifetime = 1.0f;
+    float maxLifetime = 1.0f;
+    // Pixels per second, in a direction between the two angles (degrees clockwise from the x axis)
+    float minSpeed = 0.0f;
+    float maxSpeed = 0.0f;
+    float minAngle = 0.0f;
+    float maxAngle = 360.0f;
+    // Added to every particle's velocity, and its change per second (e.g. gravity)
+    glm::vec2 velocity = glm::vec2(0.0f);
+    glm::vec2 acceleration = glm::vec2(0.0f);
+    // Particles of one emit_particles burst
+    int burstCount = 1;
+    // Particles per second of an emitter component
+    float rate = 0.0f;
+    // By age, from birth to death
+    float sizes[PARTICLE_CURVE_SAMPLES];
+    SDL_Color colors[PARTICLE_CURVE_SAMPLES];
+
+    ParticleEmitterDefinition();
+    // Piecewise linear through (time, value) keys, time from 0 (birth) to 1 (death)
+    void SetSizeCurve(std::vector<std::pair<float, float>> keys);
+    void SetColorCurve(std::vector<std::pair<float, SDL_Color>> keys);
+};
+
+// Every live particle, stored as one array per field
+// Movement is integrated four particles at a time, and dead particles are replaced by the last
+// one, so the arrays stay packed. Particles aren't entities: a burst of hundreds costs the
+// registry nothing.
+class ParticlePool {
+    private:
+        std::vector<ParticleEmitterDefinition> definitions;
+        std::unordered_map<std::string, uint16_t> definitionIds;
+
+        std::vector<float> positionsX;
+        std::vector<float> positionsY;
+        std::vector<float> velocitiesX;
+        std::vector<float> velocitiesY;
+        std::vector<float> accelerationsX;
+        std::vector<float> accelerationsY;
+        // From 0 at birth to 1 at death, and how much of that passes per second
+        std::vector<float> ages;
+        std::vector<float> ageRates;
+        std::vector<uint16_t> emitters;
+        size_t count = 0;
+
+        // Scratch of Capture, kept from frame to frame
+        std::vector<uint32_t> captureCounts;
+        std::vector<int8_t> captureSamples;
+        uint32_t randomState = 0x9e3779b9;
+
+        float Random(float min, float max);
+        void Grow();
+        void Integrate(float deltaTime);
+        void RemoveDead();
+
+    public:
+        // Id of the definition, which replaces an earlier one of the same name
+        uint16_t AddDefinition(const ParticleEmitterDefinition& definition);
+        // -1 if there is no such definition
+        int GetDefinitionId(const std::string& name) const;
+        const ParticleEmitterDefinition& GetDefinition(uint16_t definitionId) const { return definitions[definitionId]; }
+        int GetNumDefinitions() const { return definitions.size(); }
+
+        void Emit(uint16_t definitionId, float x, float y, int numParticles);
+        // Move and age every particle, and drop the ones that died
+        void Update(float deltaTime);
+        // Copy the particles the camera sees into the snapshot, grouped by definition
+        void Capture(RenderSnapshot& snapshot, const SDL_Rect& camera);
+
+        size_t GetCount() const { return count; }
+        void Clear() { count = 0; }
+};
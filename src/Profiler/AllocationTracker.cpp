@@ -0,0 +1,123 @@
+#include <new>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "./AllocationTracker.h"
+#include "../Logger/Logger.h"
+
+std::atomic<bool> AllocationTracker::isEnabled{false};
+bool AllocationTracker::isAssertingZeroAllocations = false;
+thread_local int AllocationTracker::currentScope = ALLOCATION_SCOPE_OTHER;
+
+const char* AllocationTracker::scopeNames[ALLOCATION_MAX_SCOPES] = {"other"};
+std::atomic<int> AllocationTracker::numScopes{1};
+AllocationTracker::ScopeCounters AllocationTracker::counters[ALLOCATION_MAX_SCOPES];
+AllocationStats AllocationTracker::lastFrame[ALLOCATION_MAX_SCOPES];
+float AllocationTracker::history[ALLOCATION_HISTORY_FRAMES];
+int AllocationTracker::historyOffset = 0;
+uint64_t AllocationTracker::frameNumber = 0;
+
+static std::mutex scopesMutex;
+
+void AllocationTracker::Enable(bool assertZeroAllocations) {
+    isAssertingZeroAllocations = assertZeroAllocations;
+    isEnabled.store(true, std::memory_order_relaxed);
+}
+
+int AllocationTracker::GetScopeId(const char* name) {
+    // Scopes are looked up every frame, so the common case is a pointer match on the same literal
+    int count = GetNumScopes();
+    for (int i = 0; i < count; i++) {
+        if (scopeNames[i] == name) return i;
+    }
+    std::lock_guard<std::mutex> lock(scopesMutex);
+    count = GetNumScopes();
+    for (int i = 0; i < count; i++) {
+        if (strcmp(scopeNames[i], name) == 0) return i;
+    }
+    if (count == ALLOCATION_MAX_SCOPES) return ALLOCATION_SCOPE_OTHER;
+    scopeNames[count] = name;
+    numScopes.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void AllocationTracker::EndFrame() {
+    if (!IsEnabled()) return;
+
+    AllocationStats total;
+    int count = GetNumScopes();
+    for (int i = 0; i < count; i++) {
+        lastFrame[i].allocations = counters[i].allocations.exchange(0, std::memory_order_relaxed);
+        lastFrame[i].bytes = counters[i].bytes.exchange(0, std::memory_order_relaxed);
+        lastFrame[i].frees = counters[i].frees.exchange(0, std::memory_order_relaxed);
+        total.allocations += lastFrame[i].allocations;
+    }
+    history[historyOffset] = static_cast<float>(total.allocations);
+    historyOffset = (historyOffset + 1) % ALLOCATION_HISTORY_FRAMES;
+    frameNumber++;
+
+    if (!isAssertingZeroAllocations || frameNumber <= ALLOCATION_WARMUP_FRAMES || total.allocations == 0) return;
+
+    // Reporting allocates, keep it out of the counters
+    AllocationScope scope;
+    SetCurrentScope(ALLOCATION_SCOPE_IGNORED);
+    char line[128];
+    snprintf(line, sizeof(line), "Zero-allocation check failed: %llu allocations in frame %llu", static_cast<unsigned long long>(total.allocations), static_cast<unsigned long long>(frameNumber));
+    Logger::Err(line);
+    for (int i = 0; i < count; i++) {
+        if (lastFrame[i].allocations == 0) continue;
+        snprintf(line, sizeof(line), "  %-24s %6llu allocations %8llu bytes", scopeNames[i], static_cast<unsigned long long>(lastFrame[i].allocations), static_cast<unsigned long long>(lastFrame[i].bytes));
+        Logger::Err(line);
+    }
+    Logger::Flush();
+    std::abort();
+}
+
+// Global allocation functions, counted when the tracker is enabled
+
+static void* Allocate(size_t size) {
+    void* memory = malloc(size ? size : 1);
+    if (!memory) throw std::bad_alloc();
+    AllocationTracker::RecordAllocation(size);
+    return memory;
+}
+
+static void* AllocateAligned(size_t size, std::align_val_t alignment) {
+    size_t align = static_cast<size_t>(alignment);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size_t alignedSize = ((size ? size : 1) + align - 1) / align * align;
+    void* memory = aligned_alloc(align, alignedSize);
+    if (!memory) throw std::bad_alloc();
+    AllocationTracker::RecordAllocation(size);
+    return memory;
+}
+
+static void Free(void* memory) {
+    if (!memory) return;
+    AllocationTracker::RecordFree();
+    free(memory);
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return Allocate(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return Allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* memory) noexcept { Free(memory); }
+void operator delete[](void* memory) noexcept { Free(memory); }
+void operator delete(void* memory, size_t) noexcept { Free(memory); }
+void operator delete[](void* memory, size_t) noexcept { Free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { Free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { Free(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { Free(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { Free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { Free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { Free(memory); }
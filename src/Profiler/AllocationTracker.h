@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+const int ALLOCATION_MAX_SCOPES = 32;
+const int ALLOCATION_HISTORY_FRAMES = 120;
+// Frames ignored by the zero-allocation check while caches, pools and the level settle
+const int ALLOCATION_WARMUP_FRAMES = 120;
+
+// Scope used by allocations outside of any marked scope
+const int ALLOCATION_SCOPE_OTHER = 0;
+// Scope whose allocations are not counted (the tracker's own reporting)
+const int ALLOCATION_SCOPE_IGNORED = -1;
+
+struct AllocationStats {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+};
+
+// Counts heap allocations made through the global operator new, per frame and per scope
+// Scopes are marked on the thread doing the work; allocations on threads without a scope land in "other".
+class AllocationTracker {
+    private:
+        struct ScopeCounters {
+            std::atomic<uint64_t> allocations{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> frees{0};
+        };
+
+        static std::atomic<bool> isEnabled;
+        static bool isAssertingZeroAllocations;
+        static thread_local int currentScope;
+
+        static const char* scopeNames[ALLOCATION_MAX_SCOPES];
+        static std::atomic<int> numScopes;
+        static ScopeCounters counters[ALLOCATION_MAX_SCOPES];
+        static AllocationStats lastFrame[ALLOCATION_MAX_SCOPES];
+        static float history[ALLOCATION_HISTORY_FRAMES];
+        static int historyOffset;
+        static uint64_t frameNumber;
+
+    public:
+        // Start counting; with assertZeroAllocations any allocation after the warmup frames is fatal
+        static void Enable(bool assertZeroAllocations);
+        static bool IsEnabled() { return isEnabled.load(std::memory_order_relaxed); }
+
+        // Id of a scope by name; names must outlive the tracker (string literals)
+        static int GetScopeId(const char* name);
+        static int GetCurrentScope() { return currentScope; }
+        static void SetCurrentScope(int scope) { currentScope = scope; }
+
+        // Called from the global operator new/delete, must not allocate
+        static void RecordAllocation(size_t size) {
+            if (!IsEnabled() || currentScope == ALLOCATION_SCOPE_IGNORED) return;
+            ScopeCounters& scope = counters[currentScope];
+            scope.allocations.fetch_add(1, std::memory_order_relaxed);
+            scope.bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        static void RecordFree() {
+            if (!IsEnabled() || currentScope == ALLOCATION_SCOPE_IGNORED) return;
+            counters[currentScope].frees.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Move this frame's counters into the last frame stats and the history, and run the zero-allocation check
+        static void EndFrame();
+
+        static int GetNumScopes() { return numScopes.load(std::memory_order_acquire); }
+        static const char* GetScopeName(int scope) { return scopeNames[scope]; }
+        static const AllocationStats& GetLastFrame(int scope) { return lastFrame[scope]; }
+        // Allocations per frame, oldest first starting at GetHistoryOffset()
+        static const float* GetHistory() { return history; }
+        static int GetHistoryOffset() { return historyOffset; }
+};
+
+// Attributes allocations on this thread to a scope until the next Enter or destruction
+// Example:
+//     AllocationScope scope;
+//     scope.Enter("MovementSystem");
+//     registry -> GetSystem<MovementSystem>().Update(deltaTime);
+class AllocationScope {
+    private:
+        int previousScope;
+
+    public:
+        AllocationScope(): previousScope(AllocationTracker::GetCurrentScope()) {}
+        AllocationScope(const char* name): AllocationScope() { Enter(name); }
+        ~AllocationScope() { AllocationTracker::SetCurrentScope(previousScope); }
+
+        void Enter(const char* name) {
+            if (AllocationTracker::IsEnabled()) AllocationTracker::SetCurrentScope(AllocationTracker::GetScopeId(name));
+        }
+};
@@ -0,0 +1,70 @@
+#include <map>
+#include <cstdio>
+#include <algorithm>
+#include "./StartupTimeline.h"
+#include "../Logger/Logger.h"
+
+using namespace std;
+
+mutex StartupTimeline::phasesMutex;
+vector<StartupTimeline::Phase> StartupTimeline::phases;
+chrono::steady_clock::time_point StartupTimeline::origin = chrono::steady_clock::now();
+double StartupTimeline::timeToFirstFrame = 0.0;
+
+static double Milliseconds(chrono::steady_clock::duration duration) {
+    return chrono::duration<double, milli>(duration).count();
+}
+
+void StartupTimeline::Start() {
+    lock_guard<mutex> lock(phasesMutex);
+    phases.clear();
+    timeToFirstFrame = 0.0;
+    origin = chrono::steady_clock::now();
+}
+
+int StartupTimeline::BeginPhase(const string& name) {
+    lock_guard<mutex> lock(phasesMutex);
+    auto now = chrono::steady_clock::now();
+    phases.push_back({name, this_thread::get_id(), now, now});
+    return phases.size() - 1;
+}
+
+void StartupTimeline::EndPhase(int phase) {
+    lock_guard<mutex> lock(phasesMutex);
+    phases[phase].end = chrono::steady_clock::now();
+}
+
+void StartupTimeline::MarkFirstFrame() {
+    if (timeToFirstFrame > 0.0) return;
+    timeToFirstFrame = Milliseconds(chrono::steady_clock::now() - origin);
+    Report();
+}
+
+void StartupTimeline::Report() {
+    lock_guard<mutex> lock(phasesMutex);
+
+    // Number threads in order of appearance, the thread that started the timeline is usually 0
+    map<thread::id, int> threadNumbers;
+    for (auto& phase: phases) threadNumbers.emplace(phase.thread, threadNumbers.size());
+
+    double total = max(timeToFirstFrame, 1.0);
+    const int barWidth = 40;
+    char line[160];
+
+    Logger::Log("Startup timeline (start ms, duration ms, thread):");
+    for (auto& phase: phases) {
+        double start = Milliseconds(phase.start - origin);
+        double duration = Milliseconds(phase.end - phase.start);
+
+        // Bar showing where the phase sits between start and first frame
+        string bar(barWidth, ' ');
+        int from = min(barWidth - 1, static_cast<int>(start / total * barWidth));
+        int to = max(from + 1, min(barWidth, static_cast<int>((start + duration) / total * barWidth)));
+        fill(bar.begin() + from, bar.begin() + to, '#');
+
+        snprintf(line, sizeof(line), "%-20s %8.2f %8.2f  T%d |%s|", phase.name.c_str(), start, duration, threadNumbers[phase.thread], bar.c_str());
+        Logger::Log(line);
+    }
+    snprintf(line, sizeof(line), "Time to first frame: %.2f ms", timeToFirstFrame);
+    Logger::Log(line);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Records how long each boot phase takes and on which thread it ran
+// Phases can be recorded from any thread; the report is printed once the first frame is shown.
+class StartupTimeline {
+    private:
+        struct Phase {
+            std::string name;
+            std::thread::id thread;
+            std::chrono::steady_clock::time_point start;
+            std::chrono::steady_clock::time_point end;
+        };
+
+        static std::mutex phasesMutex;
+        static std::vector<Phase> phases;
+        static std::chrono::steady_clock::time_point origin;
+        static double timeToFirstFrame;
+
+    public:
+        // Reset the timeline; times are measured from this call
+        static void Start();
+        static int BeginPhase(const std::string& name);
+        static void EndPhase(int phase);
+
+        // Record the time to first frame and log the timeline
+        static void MarkFirstFrame();
+        // Milliseconds from Start() to the first presented frame, 0 until it happens
+        static double GetTimeToFirstFrame() { return timeToFirstFrame; }
+        static void Report();
+};
+
+// Records a phase for the lifetime of the object
+class StartupPhase {
+    private:
+        int phase;
+
+    public:
+        StartupPhase(const std::string& name) { phase = StartupTimeline::BeginPhase(name); }
+        ~StartupPhase() { StartupTimeline::EndPhase(phase); }
+};
@@ -0,0 +1,93 @@
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include "./DynamicResolution.h"
+#include "../Logger/Logger.h"
+#include "../Telemetry/Telemetry.h"
+
+// Weight of the newest sample in the frame time moving average
+const double FRAME_TIME_SMOOTHING = 0.1;
+// Scale change applied per adjustment
+const float SCALE_STEP = 0.05f;
+// Frames between two adjustments, so the average can settle on the new cost
+const int SCALE_COOLDOWN_FRAMES = 15;
+
+DynamicResolution::DynamicResolution(float minScale, float maxScale, double targetFrameTime) {
+    this -> minScale = minScale;
+    this -> maxScale = maxScale;
+    this -> scale = maxScale;
+    this -> targetFrameTime = targetFrameTime;
+    this -> averageFrameTime = targetFrameTime;
+}
+
+DynamicResolution::~DynamicResolution() {
+    Destroy();
+}
+
+bool DynamicResolution::Initialize(SDL_Renderer* renderer, int windowWidth, int windowHeight) {
+    this -> renderer = renderer;
+    this -> windowWidth = windowWidth;
+    this -> windowHeight = windowHeight;
+
+    // Render targets are supported by both the accelerated and the software renderers
+    target = SDL_CreateTexture(
+        renderer,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_TARGET,
+        static_cast<int>(ceil(windowWidth * maxScale)),
+        static_cast<int>(ceil(windowHeight * maxScale))
+    );
+    if (!target) {
+        Logger::Err("Error creating dynamic resolution target: " + std::string(SDL_GetError()));
+        return false;
+    }
+    SDL_SetTextureScaleMode(target, SDL_ScaleModeLinear);
+    return true;
+}
+
+void DynamicResolution::Destroy() {
+    if (target) SDL_DestroyTexture(target);
+    target = nullptr;
+}
+
+void DynamicResolution::RecordFrameTime(double frameTime) {
+    averageFrameTime += (frameTime - averageFrameTime) * FRAME_TIME_SMOOTHING;
+
+    if (cooldownFrames > 0) {
+        cooldownFrames--;
+        return;
+    }
+
+    // Hysteresis band: only scale up with a clear margin, to avoid oscillating around the budget
+    float newScale = scale;
+    if (averageFrameTime > targetFrameTime) newScale = std::max(minScale, scale - SCALE_STEP);
+    else if (averageFrameTime < targetFrameTime * 0.8) newScale = std::min(maxScale, scale + SCALE_STEP);
+
+    if (newScale != scale) {
+        scale = newScale;
+        cooldownFrames = SCALE_COOLDOWN_FRAMES;
+    }
+}
+
+void DynamicResolution::BeginWorld() {
+    if (!target) return;
+    // Changing the target resets the render scale, so the scale has to be set afterwards
+    SDL_SetRenderTarget(renderer, target);
+    SDL_RenderSetScale(renderer, scale, scale);
+    SDL_RenderClear(renderer);
+}
+
+void DynamicResolution::EndWorld() {
+    if (!target) return;
+    SDL_SetRenderTarget(renderer, NULL);
+
+    // Only the top-left part of the target covered at the current scale holds the frame
+    SDL_Rect srcRect = {
+        0,
+        0,
+        static_cast<int>(windowWidth * scale),
+        static_cast<int>(windowHeight * scale)
+    };
+    SDL_RenderCopy(renderer, target, &srcRect, NULL);
+    Telemetry::Add(TELEMETRY_DRAW_CALLS);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// Renders the world into an offscreen target texture and upscales it to the window
+// The fraction of the target that is used (the scale) follows the measured frame time:
+// it drops when frames run over budget and climbs back when there is headroom.
+// Anything drawn outside BeginWorld()/EndWorld() (HUD, fixed sprites, debug GUI)
+// is rendered at the native window resolution.
+class DynamicResolution {
+    private:
+        SDL_Renderer* renderer = nullptr;
+        SDL_Texture* target = nullptr;
+        int windowWidth = 0;
+        int windowHeight = 0;
+
+        float minScale;
+        float maxScale;
+        float scale;
+        double targetFrameTime;
+        double averageFrameTime;
+        // Frames to wait after a change before the scale can move again
+        int cooldownFrames = 0;
+
+    public:
+        DynamicResolution(float minScale, float maxScale, double targetFrameTime);
+        ~DynamicResolution();
+
+        // Create the offscreen target, sized for the largest allowed scale
+        bool Initialize(SDL_Renderer* renderer, int windowWidth, int windowHeight);
+        void Destroy();
+
+        // Feed the time spent on the last frame, in milliseconds
+        void RecordFrameTime(double frameTime);
+
+        // Redirect rendering into the scaled offscreen target
+        void BeginWorld();
+        // Restore the window as render target and upscale the world onto it
+        void EndWorld();
+
+        float GetScale() const { return scale; }
+        double GetAverageFrameTime() const { return averageFrameTime; }
+};
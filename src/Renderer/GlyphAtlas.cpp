@@ -0,0 +1,80 @@
+#include <algorithm>
+#include "../Logger/Logger.h"
+#include "./GlyphAtlas.h"
+
+const int NUM_GLYPHS = GLYPH_LAST - GLYPH_FIRST + 1;
+
+GlyphAtlas::~GlyphAtlas() {
+    if (texture) SDL_DestroyTexture(texture);
+}
+
+bool GlyphAtlas::Build(SDL_Renderer* renderer, TTF_Font* font) {
+    if (!renderer || !font) return false;
+    lineHeight = TTF_FontHeight(font);
+
+    // Rasterize every glyph and place it on shelves one line high
+    SDL_Surface* glyphSurfaces[NUM_GLYPHS] = {};
+    int x = 0;
+    int y = 0;
+    for (int i = 0; i < NUM_GLYPHS; i++) {
+        Uint16 character = GLYPH_FIRST + i;
+        int advance = 0;
+        TTF_GlyphMetrics(font, character, NULL, NULL, NULL, NULL, &advance);
+        glyphSurfaces[i] = TTF_RenderGlyph_Blended(font, character, {255, 255, 255, 255});
+        int width = glyphSurfaces[i] ? std::min(glyphSurfaces[i] -> w, GLYPH_ATLAS_WIDTH) : 0;
+        if (x + width > GLYPH_ATLAS_WIDTH) {
+            x = 0;
+            y += lineHeight;
+        }
+        glyphs[i] = {{x, y, width, lineHeight}, advance};
+        x += width;
+    }
+
+    SDL_Surface* atlas = SDL_CreateRGBSurfaceWithFormat(0, GLYPH_ATLAS_WIDTH, y + lineHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (atlas) {
+        for (int i = 0; i < NUM_GLYPHS; i++) {
+            if (!glyphSurfaces[i]) continue;
+            // Copy the alpha as is instead of blending it onto the empty atlas
+            SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+            SDL_Rect srcRect = {0, 0, glyphs[i].srcRect.w, std::min(glyphSurfaces[i] -> h, lineHeight)};
+            SDL_Rect destRect = glyphs[i].srcRect;
+            SDL_BlitSurface(glyphSurfaces[i], &srcRect, atlas, &destRect);
+        }
+        texture = SDL_CreateTextureFromSurface(renderer, atlas);
+        SDL_FreeSurface(atlas);
+    }
+    for (auto surface: glyphSurfaces) {
+        if (surface) SDL_FreeSurface(surface);
+    }
+
+    if (!texture) {
+        Logger::Err("Could not create a glyph atlas: {}", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+const Glyph& GlyphAtlas::GetGlyph(char character) const {
+    if (character < GLYPH_FIRST || character > GLYPH_LAST) character = '?';
+    return glyphs[character - GLYPH_FIRST];
+}
+
+int GlyphAtlas::Measure(std::string_view text) const {
+    int width = 0;
+    for (char character: text) width += GetGlyph(character).advance;
+    return width;
+}
+
+int GlyphAtlas::Draw(SpriteBatcher& batcher, int layer, std::string_view text, float x, float y, SDL_Color color) const {
+    float penX = x;
+    for (char character: text) {
+        const Glyph& glyph = GetGlyph(character);
+        if (glyph.srcRect.w > 0) {
+            SDL_FRect destRect = {penX, y, static_cast<float>(glyph.srcRect.w), static_cast<float>(glyph.srcRect.h)};
+            batcher.Add(layer, texture, glyph.srcRect, destRect, 0.0, SDL_FLIP_NONE, color);
+        }
+        penX += glyph.advance;
+    }
+    return static_cast<int>(penX - x);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string_view>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include "./SpriteBatcher.h"
+
+// Printable ASCII, other characters are drawn as '?'
+const char GLYPH_FIRST = ' ';
+const char GLYPH_LAST = '~';
+const int GLYPH_ATLAS_WIDTH = 512;
+
+struct Glyph {
+    // Where the glyph is in the atlas, one line high
+    SDL_Rect srcRect;
+    int advance;
+};
+
+// Every glyph of one font, rasterized once in white into a single texture
+// Text is laid out glyph by glyph into a SpriteBatcher and tinted through the vertex color, so
+// drawing a string that changes every frame ("87%") doesn't rasterize or allocate anything.
+// Kerning is not applied, use the TextCache for labels where it matters.
+class GlyphAtlas {
+    private:
+        SDL_Texture* texture = nullptr;
+        Glyph glyphs[GLYPH_LAST - GLYPH_FIRST + 1];
+        int lineHeight = 0;
+
+        const Glyph& GetGlyph(char character) const;
+
+    public:
+        GlyphAtlas() = default;
+        GlyphAtlas(const GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+        ~GlyphAtlas();
+
+        bool Build(SDL_Renderer* renderer, TTF_Font* font);
+
+        // Width of the text in pixels
+        int Measure(std::string_view text) const;
+        // Add the quads of the text with its top left corner at x, y, returns its width
+        int Draw(SpriteBatcher& batcher, int layer, std::string_view text, float x, float y, SDL_Color color) const;
+
+        int GetLineHeight() const { return lineHeight; }
+};
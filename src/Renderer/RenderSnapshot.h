@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <SDL2/SDL.h>
+
+// Items captured for one frame, with the storage kept from frame to frame
+// Clear() only forgets the items, so their strings and the vector keep their capacity
+// and a steady scene captures without allocating.
+template <typename T>
+class SnapshotList {
+    private:
+        std::vector<T> items;
+        size_t count = 0;
+
+    public:
+        T& Add() {
+            if (count == items.size()) items.emplace_back();
+            return items[count++];
+        }
+        void Clear() { count = 0; }
+        size_t Size() const { return count; }
+        typename std::vector<T>::const_iterator begin() const { return items.begin(); }
+        typename std::vector<T>::const_iterator end() const { return items.begin() + count; }
+};
+
+struct SpriteInstance {
+    std::string assetId;
+    SDL_Rect srcRect;
+    // On screen, the camera already applied
+    SDL_FRect destRect;
+    double rotation;
+    SDL_RendererFlip flip;
+    int layer;
+    bool isFixed;
+};
+
+struct LabelInstance {
+    std::string text;
+    std::string assetId;
+    // On screen, the camera already applied
+    SDL_FPoint position;
+    SDL_Color color;
+    bool isFixed;
+};
+
+struct HealthInstance {
+    // Top left of the bar on screen
+    SDL_Point position;
+    int healthPercentage;
+};
+
+struct ParticleInstance {
+    // Center on screen, the camera already applied
+    float x;
+    float y;
+    float size;
+    SDL_Color color;
+};
+
+// Everything the renderer needs from the simulation for one frame
+// The simulation thread fills one while the main thread draws the other, so rendering never
+// reads components that are being updated.
+struct RenderSnapshot {
+    uint32_t frameNumber = 0;
+    SDL_Rect camera = {0, 0, 0, 0};
+    SnapshotList<SpriteInstance> sprites;
+    SnapshotList<LabelInstance> labels;
+    SnapshotList<HealthInstance> healthBars;
+    // Grouped by emitter definition: those of definition i are from particleRanges[i] to particleRanges[i + 1]
+    std::vector<ParticleInstance> particles;
+    std::vector<uint32_t> particleRanges;
+
+    void Clear() {
+        sprites.Clear();
+        labels.Clear();
+        healthBars.Clear();
+        particles.clear();
+        particleRanges.clear();
+    }
+};
@@ -0,0 +1,175 @@
+#include <cmath>
+#include <algorithm>
+#include "../Telemetry/Telemetry.h"
+#include "./SpriteBatcher.h"
+
+void SpriteBatcher::SetLayerOrdered(int layer, bool isOrdered) {
+    if (layer < 0) return;
+    if (layer >= static_cast<int>(orderedLayers.size())) {
+        orderedLayers.resize(layer + 1, false);
+        layerRuns.resize(layer + 1, {nullptr, -1});
+    }
+    orderedLayers[layer] = isOrdered;
+}
+
+SpriteBatch& SpriteBatcher::GetBatch(int layer, SDL_Texture* texture) {
+    int run = 0;
+    if (layer >= 0 && layer < static_cast<int>(orderedLayers.size()) && orderedLayers[layer]) {
+        auto& layerRun = layerRuns[layer];
+        if (layerRun.first != texture) {
+            layerRun.first = texture;
+            layerRun.second++;
+        }
+        run = layerRun.second;
+    }
+
+    auto batchIndex = batchIndices.find({layer, run, texture});
+    int index;
+    if (batchIndex != batchIndices.end()) {
+        index = batchIndex -> second;
+        if (!batches[index].vertices.empty()) return batches[index];
+    } else {
+        index = batches.size();
+        batches.push_back({layer, run, texture, 0, 0, 0, 0, {}, {}});
+        batchIndices.emplace(std::make_tuple(layer, run, texture), index);
+    }
+
+    // First quad of the frame
+    SpriteBatch& batch = batches[index];
+    batch.firstUse = usedBatches.size();
+    batch.idleFlushes = 0;
+    usedBatches.push_back(index);
+    // The texture may have been destroyed and another one created at the same address
+    SDL_QueryTexture(texture, nullptr, nullptr, &batch.textureWidth, &batch.textureHeight);
+    return batch;
+}
+
+void SpriteBatcher::Add(int layer, SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_FRect& destRect, double angle, SDL_RendererFlip flip, SDL_Color color) {
+    if (!texture) return;
+    SpriteBatch& batch = GetBatch(layer, texture);
+    if (batch.textureWidth == 0 || batch.textureHeight == 0) return;
+
+    // Texture coordinates of the source rectangle, swapped for flipped sprites
+    float u0 = static_cast<float>(srcRect.x) / batch.textureWidth;
+    float v0 = static_cast<float>(srcRect.y) / batch.textureHeight;
+    float u1 = static_cast<float>(srcRect.x + srcRect.w) / batch.textureWidth;
+    float v1 = static_cast<float>(srcRect.y + srcRect.h) / batch.textureHeight;
+    if (flip & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+    if (flip & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+    // Corners around the center: top left, top right, bottom right, bottom left
+    float halfWidth = destRect.w * 0.5f;
+    float halfHeight = destRect.h * 0.5f;
+    float centerX = destRect.x + halfWidth;
+    float centerY = destRect.y + halfHeight;
+    const float cornersX[4] = {-halfWidth, halfWidth, halfWidth, -halfWidth};
+    const float cornersY[4] = {-halfHeight, -halfHeight, halfHeight, halfHeight};
+    const float cornersU[4] = {u0, u1, u1, u0};
+    const float cornersV[4] = {v0, v0, v1, v1};
+
+    float cosine = 1.0f;
+    float sine = 0.0f;
+    if (angle != 0.0) {
+        double radians = angle * M_PI / 180.0;
+        cosine = static_cast<float>(cos(radians));
+        sine = static_cast<float>(sin(radians));
+    }
+
+    int firstVertex = batch.vertices.size();
+    for (int i = 0; i < 4; i++) {
+        SDL_Vertex vertex;
+        vertex.position.x = centerX + cornersX[i] * cosine - cornersY[i] * sine;
+        vertex.position.y = centerY + cornersX[i] * sine + cornersY[i] * cosine;
+        vertex.color = color;
+        vertex.tex_coord.x = cornersU[i];
+        vertex.tex_coord.y = cornersV[i];
+        batch.vertices.push_back(vertex);
+    }
+    const int quadIndices[6] = {0, 1, 2, 0, 2, 3};
+    for (int index: quadIndices) batch.indices.push_back(firstVertex + index);
+}
+
+SDL_Vertex* SpriteBatcher::AddQuads(int layer, SDL_Texture* texture, int numQuads) {
+    if (!texture || numQuads <= 0) return nullptr;
+    SpriteBatch& batch = GetBatch(layer, texture);
+    if (batch.textureWidth == 0 || batch.textureHeight == 0) return nullptr;
+
+    int firstVertex = batch.vertices.size();
+    size_t firstIndex = batch.indices.size();
+    batch.vertices.resize(firstVertex + numQuads * 4);
+    batch.indices.resize(firstIndex + numQuads * 6);
+    int* indices = batch.indices.data() + firstIndex;
+    for (int vertex = firstVertex; vertex < firstVertex + numQuads * 4; vertex += 4) {
+        *indices++ = vertex;
+        *indices++ = vertex + 1;
+        *indices++ = vertex + 2;
+        *indices++ = vertex;
+        *indices++ = vertex + 2;
+        *indices++ = vertex + 3;
+    }
+    return batch.vertices.data() + firstVertex;
+}
+
+template <typename TPredicate>
+void SpriteBatcher::RemoveBatches(TPredicate isRemoved) {
+    // New index of every batch, -1 for the removed ones
+    std::vector<int> newIndices(batches.size(), -1);
+    size_t numKept = 0;
+    for (size_t i = 0; i < batches.size(); i++) {
+        if (isRemoved(batches[i])) continue;
+        if (numKept != i) batches[numKept] = std::move(batches[i]);
+        newIndices[i] = numKept++;
+    }
+    batches.resize(numKept);
+
+    batchIndices.clear();
+    for (size_t i = 0; i < batches.size(); i++) batchIndices.emplace(std::make_tuple(batches[i].layer, batches[i].run, batches[i].texture), i);
+    size_t numUsed = 0;
+    for (int batchIndex: usedBatches) {
+        if (newIndices[batchIndex] >= 0) usedBatches[numUsed++] = newIndices[batchIndex];
+    }
+    usedBatches.resize(numUsed);
+}
+
+void SpriteBatcher::Forget(SDL_Texture* texture) {
+    if (!texture) return;
+    bool hasBatches = std::any_of(batches.begin(), batches.end(), [texture](const SpriteBatch& batch) { return batch.texture == texture; });
+    if (hasBatches) RemoveBatches([texture](const SpriteBatch& batch) { return batch.texture == texture; });
+}
+
+void SpriteBatcher::Flush(SDL_Renderer* renderer) {
+    int numBatches = stats.batches;
+    int numQuads = stats.quads;
+    int numTextureSwitches = stats.textureSwitches;
+    std::sort(usedBatches.begin(), usedBatches.end(), [this](int a, int b) {
+        if (batches[a].layer != batches[b].layer) return batches[a].layer < batches[b].layer;
+        return batches[a].firstUse < batches[b].firstUse;
+    });
+
+    SDL_Texture* lastTexture = nullptr;
+    for (int batchIndex: usedBatches) {
+        SpriteBatch& batch = batches[batchIndex];
+        // Only textures that couldn't be queried stay empty
+        if (batch.vertices.empty()) continue;
+        SDL_RenderGeometry(renderer, batch.texture, batch.vertices.data(), batch.vertices.size(), batch.indices.data(), batch.indices.size());
+        if (batch.texture != lastTexture) stats.textureSwitches++;
+        lastTexture = batch.texture;
+        stats.batches++;
+        stats.quads += batch.vertices.size() / 4;
+        // Keep the capacity for the next frame
+        batch.vertices.clear();
+        batch.indices.clear();
+    }
+    usedBatches.clear();
+    std::fill(layerRuns.begin(), layerRuns.end(), std::make_pair(static_cast<SDL_Texture*>(nullptr), -1));
+
+    bool hasIdleBatches = false;
+    for (SpriteBatch& batch: batches) {
+        if (++batch.idleFlushes > SPRITE_BATCH_IDLE_FLUSHES) hasIdleBatches = true;
+    }
+    if (hasIdleBatches) RemoveBatches([](const SpriteBatch& batch) { return batch.idleFlushes > SPRITE_BATCH_IDLE_FLUSHES; });
+
+    Telemetry::Add(TELEMETRY_DRAW_CALLS, stats.batches - numBatches);
+    Telemetry::Add(TELEMETRY_TEXTURE_SWITCHES, stats.textureSwitches - numTextureSwitches);
+    Telemetry::Add(TELEMETRY_SPRITE_QUADS, stats.quads - numQuads);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <map>
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <SDL2/SDL.h>
+
+// What was submitted since the last ResetStats()
+struct SpriteBatchStats {
+    int batches = 0;
+    int quads = 0;
+    int textureSwitches = 0;
+};
+
+// Flushes a batch may go unused before its buffers are given back
+const int SPRITE_BATCH_IDLE_FLUSHES = 120;
+
+struct SpriteBatch {
+    int layer;
+    // Position among the texture runs of an ordered layer, 0 in other layers
+    int run;
+    SDL_Texture* texture;
+    int textureWidth;
+    int textureHeight;
+    // Order the batch was first used in this frame, keeps the submission stable within a layer
+    int firstUse;
+    // Flushes since the batch last had quads
+    int idleFlushes;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
+
+// Collects sprite quads into one vertex/index buffer per (layer, texture), and draws each buffer
+// with a single SDL_RenderGeometry call, layers in ascending order
+// Rotation and flip are applied to the vertices, the way SDL_RenderCopyEx would: rotation in
+// degrees, clockwise, around the center of the destination rectangle.
+// In an ordered layer quads keep their submission order: a batch only grows while the texture
+// stays the same, and a texture change starts a new run.
+// Buffers are kept from frame to frame, so a steady scene doesn't allocate. Batches left unused
+// for SPRITE_BATCH_IDLE_FLUSHES flushes are dropped, and Forget drops a texture's at once.
+class SpriteBatcher {
+    private:
+        std::vector<SpriteBatch> batches;
+        // Batch index by (layer, run, texture)
+        std::map<std::tuple<int, int, SDL_Texture*>, int> batchIndices;
+        // Whether each layer keeps its submission order [index = layer]
+        std::vector<bool> orderedLayers;
+        // Texture and run of each ordered layer's last quad this frame [index = layer]
+        std::vector<std::pair<SDL_Texture*, int>> layerRuns;
+        // Batches with quads this frame, in submission order after Flush sorts them
+        std::vector<int> usedBatches;
+        SpriteBatchStats stats;
+
+        SpriteBatch& GetBatch(int layer, SDL_Texture* texture);
+        // Drop the batches the predicate picks, keeping the indices of the others in step
+        template <typename TPredicate>
+        void RemoveBatches(TPredicate isRemoved);
+
+    public:
+        SpriteBatcher() = default;
+
+        // Draw the layer's quads in the order they are added, rather than grouped by texture
+        void SetLayerOrdered(int layer, bool isOrdered);
+
+        // The color modulates the texture, white draws it unchanged
+        void Add(int layer, SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_FRect& destRect, double angle = 0.0, SDL_RendererFlip flip = SDL_FLIP_NONE, SDL_Color color = {255, 255, 255, 255});
+        // Room for numQuads more quads in the layer's batch of the texture, for callers that write many at once:
+        // four vertices per quad, corners in the order Add uses. The indices are filled in here. The
+        // pointer is valid until the next Add or AddQuads, nullptr if the texture can't be used.
+        SDL_Vertex* AddQuads(int layer, SDL_Texture* texture, int numQuads);
+        // Draw everything added since the last flush
+        void Flush(SDL_Renderer* renderer);
+        // Drop the texture's batches, call when it is destroyed; quads of it not flushed yet are dropped too
+        void Forget(SDL_Texture* texture);
+
+        const SpriteBatchStats& GetStats() const { return stats; }
+        void ResetStats() { stats = SpriteBatchStats(); }
+};
@@ -0,0 +1,89 @@
+#include "./TextCache.h"
+
+// FNV-1a of the font, the color and the text
+static uint64_t HashText(TTF_Font* font, std::string_view text, SDL_Color color) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 0x100000001b3ull;
+    };
+    mix(reinterpret_cast<uintptr_t>(font));
+    mix((uint32_t(color.r) << 24) | (color.g << 16) | (color.b << 8) | color.a);
+    for (unsigned char character: text) mix(character);
+    return hash;
+}
+
+TextCache::TextCache(size_t capacity) {
+    this -> capacity = capacity > 0 ? capacity : 1;
+}
+
+TextCache::~TextCache() {
+    Clear();
+}
+
+void TextCache::Evict(std::list<CachedText>::iterator entry) {
+    if (entry -> texture) retiredTextures.push_back(entry -> texture);
+    entryByKey.erase(entry -> key);
+    entries.erase(entry);
+}
+
+void TextCache::BeginFrame(std::vector<SDL_Texture*>& destroyed) {
+    for (SDL_Texture* texture: retiredTextures) {
+        SDL_DestroyTexture(texture);
+        destroyed.push_back(texture);
+    }
+    retiredTextures.clear();
+    frame++;
+}
+
+const CachedText* TextCache::Get(SDL_Renderer* renderer, TTF_Font* font, std::string_view text, SDL_Color color) {
+    if (!renderer || !font || text.empty()) return nullptr;
+
+    uint64_t key = HashText(font, text, color);
+    auto found = entryByKey.find(key);
+    if (found != entryByKey.end()) {
+        auto entry = found -> second;
+        const SDL_Color& entryColor = entry -> color;
+        bool isSame = entry -> font == font && entry -> text == text &&
+            entryColor.r == color.r && entryColor.g == color.g && entryColor.b == color.b && entryColor.a == color.a;
+        if (isSame) {
+            entry -> frame = frame;
+            entries.splice(entries.begin(), entries, entry);
+            return &*entry;
+        }
+        // Another string with the same hash, this one takes its place
+        Evict(entry);
+    }
+
+    // TTF_RenderText_Blended wants a terminated string
+    std::string textCopy(text);
+    SDL_Surface* surface = TTF_RenderText_Blended(font, textCopy.c_str(), color);
+    if (!surface) return nullptr;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    int width = surface -> w;
+    int height = surface -> h;
+    SDL_FreeSurface(surface);
+    if (!texture) return nullptr;
+
+    if (entries.size() >= capacity) {
+        // Every string is drawn this frame: make room rather than render them all again next frame
+        if (entries.back().frame == frame) {
+            capacity = entries.size() + 1;
+        } else {
+            Evict(std::prev(entries.end()));
+        }
+    }
+    entries.push_front({key, font, std::move(textCopy), color, texture, width, height, frame});
+    entryByKey.emplace(key, entries.begin());
+    return &entries.front();
+}
+
+void TextCache::Clear() {
+    for (SDL_Texture* texture: retiredTextures) SDL_DestroyTexture(texture);
+    retiredTextures.clear();
+    for (auto& entry: entries) {
+        if (entry.texture) SDL_DestroyTexture(entry.texture);
+    }
+    entries.clear();
+    entryByKey.clear();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+// Rendered strings kept at once, the least recently drawn go first
+// Grows when more strings than this are drawn in one frame.
+const size_t TEXT_CACHE_CAPACITY = 256;
+
+struct CachedText {
+    uint64_t key;
+    TTF_Font* font;
+    std::string text;
+    SDL_Color color;
+    SDL_Texture* texture;
+    int width;
+    int height;
+    // Last frame the text was asked for
+    uint32_t frame;
+};
+
+// LRU cache of whole strings rendered with TTF_RenderText_Blended, for labels that rarely change
+// A hit costs a hash of the text and a list splice, nothing is allocated.
+class TextCache {
+    private:
+        // Most recently used first
+        std::list<CachedText> entries;
+        std::unordered_map<uint64_t, std::list<CachedText>::iterator> entryByKey;
+        size_t capacity;
+        uint32_t frame = 0;
+        // Textures evicted since BeginFrame, they may still be waiting to be drawn
+        std::vector<SDL_Texture*> retiredTextures;
+
+        void Evict(std::list<CachedText>::iterator entry);
+
+    public:
+        explicit TextCache(size_t capacity = TEXT_CACHE_CAPACITY);
+        TextCache(const TextCache&) = delete;
+        TextCache& operator=(const TextCache&) = delete;
+        ~TextCache();
+
+        // Call before the frame's texts are asked for, once the previous frame's were drawn
+        // Destroys the evicted textures and appends them to destroyed, for the batchers to forget.
+        void BeginFrame(std::vector<SDL_Texture*>& destroyed);
+        // The rendered text, or nullptr if it can't be rendered (empty text, no font)
+        // Its texture stays alive until the next BeginFrame.
+        const CachedText* Get(SDL_Renderer* renderer, TTF_Font* font, std::string_view text, SDL_Color color);
+        void Clear();
+};
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include "../Logger/Logger.h"
+#include "./TileLayer.h"
+
+TileLayer::~TileLayer() {
+    ReleaseChunks();
+}
+
+void TileLayer::Load(const std::vector<std::vector<int>>& tileMap, const TextureRegion& tileSet, int tileSetColumns, int tileSize, double scale) {
+    ReleaseChunks();
+    rows = tileMap.size();
+    columns = rows > 0 ? tileMap[0].size() : 0;
+    tiles.assign(columns * rows, TILE_EMPTY);
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < std::min<int>(columns, tileMap[row].size()); column++) {
+            tiles[row * columns + column] = static_cast<uint16_t>(tileMap[row][column]);
+        }
+    }
+
+    this -> tileSet = tileSet.texture;
+    tileSetOrigin = {tileSet.rect.x, tileSet.rect.y};
+    this -> tileSetColumns = std::max(tileSetColumns, 1);
+    this -> tileSize = tileSize;
+    scaledTileSize = static_cast<int>(tileSize * scale);
+    chunkTiles = std::max(TILE_CHUNK_SIZE / std::max(scaledTileSize, 1), 1);
+    chunkColumns = (columns + chunkTiles - 1) / chunkTiles;
+    chunkRows = (rows + chunkTiles - 1) / chunkTiles;
+    chunks.assign(chunkColumns * chunkRows, TileChunk());
+    Logger::Log("Tile layer of {}x{} tiles in {}x{} chunks", columns, rows, chunkColumns, chunkRows);
+}
+
+uint16_t TileLayer::GetTile(int column, int row) const {
+    if (column < 0 || column >= columns || row < 0 || row >= rows) return TILE_EMPTY;
+    return tiles[row * columns + column];
+}
+
+void TileLayer::SetTile(int column, int row, uint16_t tile) {
+    if (column < 0 || column >= columns || row < 0 || row >= rows) return;
+    uint16_t& current = tiles[row * columns + column];
+    if (current == tile) return;
+    current = tile;
+    chunks[(row / chunkTiles) * chunkColumns + column / chunkTiles].isDirty = true;
+}
+
+void TileLayer::EvictChunk() {
+    TileChunk* oldest = nullptr;
+    for (auto& chunk: chunks) {
+        if (!chunk.texture || chunk.lastDrawnFrame == frame) continue;
+        if (!oldest || chunk.lastDrawnFrame < oldest -> lastDrawnFrame) oldest = &chunk;
+    }
+    if (!oldest) return;
+    SDL_DestroyTexture(oldest -> texture);
+    oldest -> texture = nullptr;
+    oldest -> isDirty = true;
+    numChunkTextures--;
+}
+
+void TileLayer::DrawTiles(SDL_Renderer* renderer, int chunkColumn, int chunkRow, int x, int y) {
+    int firstColumn = chunkColumn * chunkTiles;
+    int firstRow = chunkRow * chunkTiles;
+    for (int row = firstRow; row < std::min(firstRow + chunkTiles, rows); row++) {
+        for (int column = firstColumn; column < std::min(firstColumn + chunkTiles, columns); column++) {
+            uint16_t tile = tiles[row * columns + column];
+            if (tile == TILE_EMPTY) continue;
+            SDL_Rect srcRect = {tileSetOrigin.x + (tile % tileSetColumns) * tileSize, tileSetOrigin.y + (tile / tileSetColumns) * tileSize, tileSize, tileSize};
+            SDL_Rect destRect = {x + (column - firstColumn) * scaledTileSize, y + (row - firstRow) * scaledTileSize, scaledTileSize, scaledTileSize};
+            SDL_RenderCopy(renderer, tileSet, &srcRect, &destRect);
+        }
+    }
+}
+
+void TileLayer::Bake(SDL_Renderer* renderer, int chunkColumn, int chunkRow) {
+    TileChunk& chunk = chunks[chunkRow * chunkColumns + chunkColumn];
+    int chunkPixels = chunkTiles * scaledTileSize;
+    if (!chunk.texture) {
+        if (numChunkTextures >= TILE_MAX_CHUNK_TEXTURES) EvictChunk();
+        chunk.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, chunkPixels, chunkPixels);
+        if (!chunk.texture) {
+            Logger::Err("Could not create a tile chunk texture, drawing tiles one by one: {}", SDL_GetError());
+            isBakingSupported = false;
+            return;
+        }
+        SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+        numChunkTextures++;
+    }
+
+    // Changing the target resets the render scale, put both back for whoever is drawing
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    float scaleX, scaleY;
+    SDL_RenderGetScale(renderer, &scaleX, &scaleY);
+    SDL_SetRenderTarget(renderer, chunk.texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    DrawTiles(renderer, chunkColumn, chunkRow, 0, 0);
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    SDL_RenderSetScale(renderer, scaleX, scaleY);
+    chunk.isDirty = false;
+}
+
+void TileLayer::Render(SDL_Renderer* renderer, const SDL_Rect& camera) {
+    if (!tileSet || chunks.empty()) return;
+    frame++;
+
+    int chunkPixels = chunkTiles * scaledTileSize;
+    int firstChunkColumn = std::max(camera.x / chunkPixels, 0);
+    int firstChunkRow = std::max(camera.y / chunkPixels, 0);
+    int lastChunkColumn = std::min((camera.x + camera.w) / chunkPixels, chunkColumns - 1);
+    int lastChunkRow = std::min((camera.y + camera.h) / chunkPixels, chunkRows - 1);
+
+    for (int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; chunkRow++) {
+        for (int chunkColumn = firstChunkColumn; chunkColumn <= lastChunkColumn; chunkColumn++) {
+            TileChunk& chunk = chunks[chunkRow * chunkColumns + chunkColumn];
+            chunk.lastDrawnFrame = frame;
+            SDL_Rect destRect = {chunkColumn * chunkPixels - camera.x, chunkRow * chunkPixels - camera.y, chunkPixels, chunkPixels};
+            if (isBakingSupported && (chunk.isDirty || !chunk.texture)) Bake(renderer, chunkColumn, chunkRow);
+            if (chunk.texture) {
+                SDL_RenderCopy(renderer, chunk.texture, NULL, &destRect);
+            } else {
+                DrawTiles(renderer, chunkColumn, chunkRow, destRect.x, destRect.y);
+            }
+        }
+    }
+}
+
+void TileLayer::InvalidateChunks() {
+    for (auto& chunk: chunks) chunk.isDirty = true;
+}
+
+void TileLayer::ReleaseChunks() {
+    for (auto& chunk: chunks) {
+        if (chunk.texture) SDL_DestroyTexture(chunk.texture);
+        chunk.texture = nullptr;
+        chunk.isDirty = true;
+    }
+    numChunkTextures = 0;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <SDL2/SDL.h>
+#include "../AssetStore/TextureAtlas.h"
+
+// Size of a chunk texture in pixels, rounded down to whole tiles
+const int TILE_CHUNK_SIZE = 512;
+// Chunk textures kept alive at once (512x512 RGBA is 1 MB each), the least recently drawn go first
+const int TILE_MAX_CHUNK_TEXTURES = 64;
+const uint16_t TILE_EMPTY = 0xffff;
+
+struct TileChunk {
+    SDL_Texture* texture = nullptr;
+    // The texture doesn't match the tiles (never baked, edited, or the render targets were lost)
+    bool isDirty = true;
+    uint32_t lastDrawnFrame = 0;
+};
+
+// Static tilemap, drawn from pre-rendered chunk textures instead of one sprite per tile
+// Tiles are tileset indices in a flat grid. Chunks are baked into render-target textures the first
+// time they come into view, and again only after a tile inside them changes.
+class TileLayer {
+    private:
+        std::vector<uint16_t> tiles;
+        int columns = 0;
+        int rows = 0;
+
+        SDL_Texture* tileSet = nullptr;
+        // Top left corner of the tileset in its atlas page
+        SDL_Point tileSetOrigin = {0, 0};
+        int tileSetColumns = 1;
+        int tileSize = 0;
+        // Tile size on screen, in pixels
+        int scaledTileSize = 0;
+
+        std::vector<TileChunk> chunks;
+        // Tiles along each side of a chunk
+        int chunkTiles = 1;
+        int chunkColumns = 0;
+        int chunkRows = 0;
+        int numChunkTextures = 0;
+        uint32_t frame = 0;
+        // Cleared when the renderer can't create target textures, tiles are then drawn directly
+        bool isBakingSupported = true;
+
+        // Draw the tiles of one chunk with its top left corner at x, y
+        void DrawTiles(SDL_Renderer* renderer, int chunkColumn, int chunkRow, int x, int y);
+        void Bake(SDL_Renderer* renderer, int chunkColumn, int chunkRow);
+        // Make room for one more chunk texture
+        void EvictChunk();
+
+    public:
+        TileLayer() = default;
+        ~TileLayer();
+
+        void Load(const std::vector<std::vector<int>>& tileMap, const TextureRegion& tileSet, int tileSetColumns, int tileSize, double scale);
+
+        uint16_t GetTile(int column, int row) const;
+        // Change one tile, only its chunk is baked again
+        void SetTile(int column, int row, uint16_t tile);
+
+        // Draw the chunks the camera sees, baking the ones that are out of date
+        void Render(SDL_Renderer* renderer, const SDL_Rect& camera);
+
+        // Render target contents were lost (SDL_RENDER_TARGETS_RESET): bake every chunk again
+        void InvalidateChunks();
+        // Destroy every chunk texture (SDL_RENDER_DEVICE_RESET, or the renderer going away)
+        void ReleaseChunks();
+
+        int GetNumChunkTextures() const { return numChunkTextures; }
+};
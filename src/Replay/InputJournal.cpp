@@ -0,0 +1,92 @@
+#include "../Logger/Logger.h"
+#include "./InputJournal.h"
+
+// Fixed-size little-endian fields, independent of struct padding
+static void WriteValue(FILE* file, uint64_t value, int size) {
+    uint8_t bytes[8];
+    for (int i = 0; i < size; i++) bytes[i] = (value >> (i * 8)) & 0xff;
+    fwrite(bytes, 1, size, file);
+}
+
+static bool ReadValue(FILE* file, uint64_t& value, int size) {
+    uint8_t bytes[8];
+    if (fread(bytes, 1, size, file) != static_cast<size_t>(size)) return false;
+    value = 0;
+    for (int i = 0; i < size; i++) value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+    return true;
+}
+
+InputJournal::~InputJournal() {
+    Stop();
+}
+
+bool InputJournal::StartRecording(const std::string& path, const JournalHeader& header) {
+    Stop();
+    output = fopen(path.c_str(), "wb");
+    if (!output) {
+        Logger::Err("Could not open input journal for writing: " + path);
+        return false;
+    }
+    this -> header = header;
+    WriteValue(output, header.magic, 4);
+    WriteValue(output, header.version, 4);
+    WriteValue(output, header.seed, 4);
+    WriteValue(output, header.stepMilliseconds, 4);
+    WriteValue(output, header.level, 4);
+    Logger::Log("Recording input journal to {}", path);
+    return true;
+}
+
+bool InputJournal::StartReplay(const std::string& path) {
+    Stop();
+    FILE* input = fopen(path.c_str(), "rb");
+    if (!input) {
+        Logger::Err("Could not open input journal: " + path);
+        return false;
+    }
+
+    uint64_t fields[5];
+    bool isHeaderRead = true;
+    for (auto& field: fields) isHeaderRead = isHeaderRead && ReadValue(input, field, 4);
+    if (!isHeaderRead || fields[0] != JOURNAL_MAGIC || fields[1] != JOURNAL_VERSION) {
+        Logger::Err("Not an input journal, or written by a different version: " + path);
+        fclose(input);
+        return false;
+    }
+    header.seed = fields[2];
+    header.stepMilliseconds = fields[3];
+    header.level = fields[4];
+
+    uint64_t frame, type, value;
+    while (ReadValue(input, frame, 4) && ReadValue(input, type, 1) && ReadValue(input, value, 8)) {
+        records.push_back({static_cast<uint32_t>(frame), static_cast<JournalRecordType>(type), value});
+    }
+    fclose(input);
+
+    isReplaying = true;
+    Logger::Log("Replaying input journal {} ({} frames)", path, GetLastFrame());
+    return true;
+}
+
+void InputJournal::Stop() {
+    if (output) {
+        fclose(output);
+        output = nullptr;
+    }
+    records.clear();
+    nextRecord = 0;
+    isReplaying = false;
+}
+
+void InputJournal::Record(uint32_t frame, JournalRecordType type, uint64_t value) {
+    if (!output) return;
+    WriteValue(output, frame, 4);
+    WriteValue(output, type, 1);
+    WriteValue(output, value, 8);
+}
+
+bool InputJournal::NextRecord(uint32_t frame, JournalRecordType type, JournalRecord& record) {
+    if (IsFinished() || records[nextRecord].frame != frame || records[nextRecord].type != type) return false;
+    record = records[nextRecord++];
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+const uint32_t JOURNAL_MAGIC = 0x4c4e524a;
+const uint32_t JOURNAL_VERSION = 2;
+
+enum JournalRecordType {
+    // value: SDL keycode
+    JOURNAL_KEY_DOWN,
+    JOURNAL_KEY_UP,
+    // value: world state hash after the frame's update
+    JOURNAL_STATE_HASH
+};
+
+// Written at the start of the journal
+struct JournalHeader {
+    uint32_t magic = JOURNAL_MAGIC;
+    uint32_t version = JOURNAL_VERSION;
+    // Seed of the Lua random generator
+    uint32_t seed = 0;
+    // Fixed simulation step the session was recorded with
+    uint32_t stepMilliseconds = 0;
+    uint32_t level = 1;
+};
+
+// On disk each record is 13 bytes: frame (u32), type (u8), value (u64), little-endian
+struct JournalRecord {
+    uint32_t frame;
+    JournalRecordType type;
+    uint64_t value;
+};
+
+// Binary journal of a play session: the input of every fixed-step frame plus a hash of the world after it
+// Records are written and read back in the order the game loop produces them.
+class InputJournal {
+    private:
+        JournalHeader header;
+        FILE* output = nullptr;
+
+        // Replay: every record of the journal and the next one to hand out
+        std::vector<JournalRecord> records;
+        size_t nextRecord = 0;
+        bool isReplaying = false;
+
+    public:
+        InputJournal() = default;
+        ~InputJournal();
+
+        bool StartRecording(const std::string& path, const JournalHeader& header);
+        bool StartReplay(const std::string& path);
+        void Stop();
+
+        bool IsRecording() const { return output != nullptr; }
+        bool IsReplaying() const { return isReplaying; }
+        // All records have been replayed
+        bool IsFinished() const { return nextRecord >= records.size(); }
+        const JournalHeader& GetHeader() const { return header; }
+        uint32_t GetLastFrame() const { return records.empty() ? 0 : records.back().frame; }
+
+        void Record(uint32_t frame, JournalRecordType type, uint64_t value);
+        // Take the next replayed record if it belongs to this frame and has this type
+        bool NextRecord(uint32_t frame, JournalRecordType type, JournalRecord& record);
+};
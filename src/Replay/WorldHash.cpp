@@ -0,0 +1,36 @@
+#include <cstring>
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/HealthComponent.h"
+#include "./WorldHash.h"
+
+// FNV-1a over the raw bytes of a value
+template <typename T> static uint64_t Mix(uint64_t hash, const T& value) {
+    unsigned char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    for (auto byte: bytes) {
+        hash ^= byte;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static const uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+
+uint64_t HashWorld(const std::unique_ptr<Registry>& registry) {
+    uint64_t hash = Mix(FNV_OFFSET, registry -> GetNumEntities());
+
+    // Components are summed, so the order the pools keep them in doesn't matter
+    uint64_t components = 0;
+    registry -> ForEachComponent<TransformComponent>([&](int entityId, const TransformComponent& transform) {
+        uint64_t componentHash = Mix(Mix(FNV_OFFSET, entityId), transform.position);
+        components += Mix(componentHash, transform.rotation);
+    });
+    registry -> ForEachComponent<RigidBodyComponent>([&](int entityId, const RigidBodyComponent& rigidBody) {
+        components += Mix(Mix(FNV_OFFSET ^ 1, entityId), rigidBody.velocity);
+    });
+    registry -> ForEachComponent<HealthComponent>([&](int entityId, const HealthComponent& health) {
+        components += Mix(Mix(FNV_OFFSET ^ 2, entityId), health.healthPercentage);
+    });
+    return Mix(hash, components);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include "../ECS/ECS.h"
+
+// Hash of the simulation state that matters for a replay: entity count, transforms, velocities and health
+// Components are combined independently of pool order, so only their values and owners count.
+uint64_t HashWorld(const std::unique_ptr<Registry>& registry);
@@ -0,0 +1,229 @@
+#include <tuple>
+#include <string>
+#include "../Clock/Clock.h"
+#include "../Logger/Logger.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/BoxColliderComponent.h"
+#include "../Components/HealthComponent.h"
+#include "../Systems/BehaviourSystem.h"
+#include "../Systems/RenderSystem.h"
+#include "../Systems/AnimationSystem.h"
+#include "../Systems/ParticleSystem.h"
+#include "./LuaBindings.h"
+
+// Most components each_with can hand to one function
+const int SCRIPT_MAX_EACH_WITH_COMPONENTS = 8;
+
+// A component type scripts can reach, by its name in the level files
+struct ScriptComponentType {
+    const char* name;
+    int componentId;
+    // Push a reference to the entity's component, the entity must have it
+    void (*push)(lua_State* L, Entity entity);
+};
+
+template <typename TComponent>
+static void PushComponent(lua_State* L, Entity entity) {
+    // Pushed as a pointer, so Lua reads and writes the pool's copy
+    sol::stack::push(L, &entity.GetComponent<TComponent>());
+}
+
+template <typename TComponent>
+static ScriptComponentType MakeComponentType(const char* name) {
+    return {name, Component<TComponent>::GetId(), PushComponent<TComponent>};
+}
+
+// Component of a valid entity, or nil
+template <typename TComponent>
+static TComponent* GetComponent(Registry* registry, EntityHandle handle) {
+    if (!registry -> IsValid(handle)) return nullptr;
+    Entity entity = registry -> GetEntity(handle);
+    return entity.HasComponent<TComponent>() ? &entity.GetComponent<TComponent>() : nullptr;
+}
+
+static void RegisterTypes(sol::state& lua, Registry* owner) {
+    lua.new_usertype<glm::vec2>("vec2",
+        sol::constructors<glm::vec2(float, float)>(),
+        "x", &glm::vec2::x,
+        "y", &glm::vec2::y
+    );
+    lua.new_usertype<TransformComponent>("TransformComponent",
+        sol::no_constructor,
+        "position", &TransformComponent::position,
+        "scale", &TransformComponent::scale,
+        "rotation", &TransformComponent::rotation
+    );
+    lua.new_usertype<RigidBodyComponent>("RigidBodyComponent",
+        sol::no_constructor,
+        "velocity", &RigidBodyComponent::velocity
+    );
+    lua.new_usertype<BoxColliderComponent>("BoxColliderComponent",
+        sol::no_constructor,
+        "width", &BoxColliderComponent::width,
+        "height", &BoxColliderComponent::height,
+        "offset", &BoxColliderComponent::offset,
+        "is_colliding", sol::property([](const BoxColliderComponent& collider) { return collider.isColliding; })
+    );
+    lua.new_usertype<HealthComponent>("HealthComponent",
+        sol::no_constructor,
+        "health_percentage", &HealthComponent::healthPercentage
+    );
+
+    lua.new_usertype<EntityHandle>("Entity",
+        sol::no_constructor,
+        "id", sol::property([](const EntityHandle& handle) { return handle.id; }),
+        "valid", [owner](const EntityHandle& handle) { return owner -> IsValid(handle); },
+        "kill", [owner](const EntityHandle& handle) {
+            if (owner -> IsValid(handle)) owner -> GetEntity(handle).Kill();
+        },
+        "transform", [owner](const EntityHandle& handle) { return GetComponent<TransformComponent>(owner, handle); },
+        "rigidbody", [owner](const EntityHandle& handle) { return GetComponent<RigidBodyComponent>(owner, handle); },
+        "boxcollider", [owner](const EntityHandle& handle) { return GetComponent<BoxColliderComponent>(owner, handle); },
+        "health", [owner](const EntityHandle& handle) { return GetComponent<HealthComponent>(owner, handle); },
+        // Move the entity's sprite to a named render layer
+        "set_layer", [owner](const EntityHandle& handle, const std::string& layerName) {
+            if (!owner -> IsValid(handle) || !owner -> HasSystem<RenderSystem>()) return;
+            auto& renderSystem = owner -> GetSystem<RenderSystem>();
+            int layer = renderSystem.GetLayerIndex(layerName);
+            if (layer < 0) {
+                Logger::Warn("set_layer: unknown render layer {}", layerName);
+                return;
+            }
+            renderSystem.SetSpriteLayer(owner -> GetEntity(handle), layer);
+        },
+        // Start a clip of the level's animations from its first frame
+        "play_animation", [owner](const EntityHandle& handle, const std::string& clipName) {
+            if (!owner -> IsValid(handle) || !owner -> HasSystem<AnimationSystem>()) return;
+            Entity entity = owner -> GetEntity(handle);
+            if (!entity.HasComponent<AnimationComponent>()) return;
+            uint16_t clip = owner -> GetSystem<AnimationSystem>().GetLibrary().GetClipId(clipName);
+            if (clip == NO_ANIMATION_CLIP) {
+                Logger::Warn("play_animation: unknown animation clip {}", clipName);
+                return;
+            }
+            entity.GetComponent<AnimationComponent>().Play(clip);
+        }
+    );
+}
+
+static void RegisterRegistry(sol::state& lua, Registry* owner) {
+    static const ScriptComponentType componentTypes[] = {
+        MakeComponentType<TransformComponent>("transform"),
+        MakeComponentType<RigidBodyComponent>("rigidbody"),
+        MakeComponentType<BoxColliderComponent>("boxcollider"),
+        MakeComponentType<HealthComponent>("health")
+    };
+
+    lua.new_usertype<Registry>("Registry",
+        sol::no_constructor,
+        "entity", [](Registry& registry, int entityId) -> sol::optional<EntityHandle> {
+            if (!registry.IsEntityActive(entityId)) return sol::nullopt;
+            Entity entity(entityId);
+            return registry.GetHandle(entity);
+        },
+        "entity_by_tag", [](Registry& registry, const std::string& tag) -> sol::optional<EntityHandle> {
+            if (!registry.HasEntityWithTag(tag)) return sol::nullopt;
+            return registry.GetHandle(registry.GetEntityByTag(tag));
+        },
+        "num_entities", &Registry::GetNumEntities,
+        // Calls function(entity, component, ...) for every entity with all the named components, with the
+        // components in the order of the names. Returns the number of entities visited.
+        "each_with", [](Registry& registry, const sol::table& names, const sol::function& function) {
+            const ScriptComponentType* types[SCRIPT_MAX_EACH_WITH_COMPONENTS];
+            int numTypes = 0;
+            Signature signature;
+            for (size_t i = 1; i <= names.size(); i++) {
+                std::string name = names[i];
+                const ScriptComponentType* type = nullptr;
+                for (const auto& componentType: componentTypes) {
+                    if (name == componentType.name) type = &componentType;
+                }
+                if (!type || numTypes == SCRIPT_MAX_EACH_WITH_COMPONENTS) {
+                    Logger::Err("each_with: unknown or too many components: " + name);
+                    return 0;
+                }
+                types[numTypes++] = type;
+                signature.set(type -> componentId);
+            }
+            if (numTypes == 0) return 0;
+
+            // Straight onto the Lua stack, without building argument tables per entity
+            lua_State* L = names.lua_state();
+            int numVisited = 0;
+            bool isFailed = false;
+            registry.ForEachEntityWith(signature, [&](Entity entity) {
+                if (isFailed) return;
+                function.push(L);
+                sol::stack::push(L, registry.GetHandle(entity));
+                for (int i = 0; i < numTypes; i++) types[i] -> push(L, entity);
+                if (lua_pcall(L, numTypes + 1, 0, 0) != LUA_OK) {
+                    // The error may be any value, so convert it instead of assuming a string
+                    Logger::Err("each_with: {}", luaL_tolstring(L, -1, nullptr));
+                    lua_pop(L, 2);
+                    isFailed = true;
+                    return;
+                }
+                numVisited++;
+            });
+            return numVisited;
+        }
+    );
+    lua["registry"] = owner;
+}
+
+void LuaBindings::Register(sol::state& lua, const std::unique_ptr<Registry>& registry) {
+    Registry* owner = registry.get();
+    RegisterTypes(lua, owner);
+    RegisterRegistry(lua, owner);
+    if (registry -> HasSystem<BehaviourSystem>()) registry -> GetSystem<BehaviourSystem>().Register(lua, registry);
+
+    // Ids that are not active (dead, or waiting in a recycle pool) read as zero and ignore writes
+    auto getEntity = [owner](int entityId) {
+        Entity entity(entityId);
+        entity.registry = owner;
+        return entity;
+    };
+
+    lua.set_function("get_position", [owner, getEntity](int entityId) {
+        if (!owner -> IsEntityActive(entityId)) return std::make_tuple(0.0f, 0.0f);
+        Entity entity = getEntity(entityId);
+        if (!entity.HasComponent<TransformComponent>()) return std::make_tuple(0.0f, 0.0f);
+        const auto& transform = entity.GetComponent<TransformComponent>();
+        return std::make_tuple(transform.position.x, transform.position.y);
+    });
+    lua.set_function("set_position", [owner, getEntity](int entityId, float x, float y) {
+        if (!owner -> IsEntityActive(entityId)) return;
+        Entity entity = getEntity(entityId);
+        if (entity.HasComponent<TransformComponent>()) entity.GetComponent<TransformComponent>().position = glm::vec2(x, y);
+    });
+    lua.set_function("get_velocity", [owner, getEntity](int entityId) {
+        if (!owner -> IsEntityActive(entityId)) return std::make_tuple(0.0f, 0.0f);
+        Entity entity = getEntity(entityId);
+        if (!entity.HasComponent<RigidBodyComponent>()) return std::make_tuple(0.0f, 0.0f);
+        const auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+        return std::make_tuple(rigidBody.velocity.x, rigidBody.velocity.y);
+    });
+    lua.set_function("set_velocity", [owner, getEntity](int entityId, float x, float y) {
+        if (!owner -> IsEntityActive(entityId)) return;
+        Entity entity = getEntity(entityId);
+        if (entity.HasComponent<RigidBodyComponent>()) entity.GetComponent<RigidBodyComponent>().velocity = glm::vec2(x, y);
+    });
+    lua.set_function("kill_entity", [owner, getEntity](int entityId) {
+        if (owner -> IsEntityActive(entityId)) getEntity(entityId).Kill();
+    });
+    lua.set_function("get_ticks", []() {
+        return Clock::Now();
+    });
+    // A burst of an emitter's particles at a world position, its count unless one is given
+    lua.set_function("emit_particles", [owner](const std::string& name, float x, float y, sol::optional<int> count) {
+        if (!owner -> HasSystem<ParticleSystem>()) return;
+        auto& pool = owner -> GetSystem<ParticleSystem>().GetPool();
+        int definition = pool.GetDefinitionId(name);
+        if (definition < 0) {
+            Logger::Warn("emit_particles: unknown particle emitter {}", name);
+            return;
+        }
+        pool.Emit(definition, x, y, count ? *count : pool.GetDefinition(definition).burstCount);
+    });
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include <sol/sol.hpp>
+#include "../ECS/ECS.h"
+
+// Engine functions and types available to level scripts
+//
+// Entity ids, as handed to on_update scripts:
+//     get_position(entity) -> x, y          set_position(entity, x, y)
+//     get_velocity(entity) -> x, y          set_velocity(entity, x, y)
+//     kill_entity(entity)                   get_ticks() -> milliseconds
+//
+// The registry and components, read and written in place in the component pools:
+//     local tank = registry:entity(id)      -- Entity handle, nil if the id is not alive
+//     tank:valid()                          -- false once the entity is killed, even if its id is reused
+//     tank:transform().position.x = 10      -- nil when the entity has no such component
+//     registry:each_with({"transform", "rigidbody"}, function(entity, transform, rigidbody) ... end)
+// Components returned to Lua point into the pools: use them during the call that got them, and keep
+// Entity handles rather than components across frames.
+//
+// Behaviours, coroutines run by BehaviourSystem:
+//     start_behaviour(function, entity) -> id   stop_behaviour(id)   emit_event(name)
+//     wait(seconds)   wait_frames(frames)   wait_event(name)   -- inside a behaviour
+class LuaBindings {
+    public:
+        static void Register(sol::state& lua, const std::unique_ptr<Registry>& registry);
+};
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include "../Logger/Logger.h"
+#include "./ScriptCache.h"
+
+// FNV-1a of the source text
+static uint64_t HashSource(const std::string& source) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char byte: source) {
+        hash ^= byte;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static bool ReadFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::stringstream stream;
+    stream << file.rdbuf();
+    contents = stream.str();
+    return true;
+}
+
+static int WriteBytecode(lua_State*, const void* data, size_t size, void* buffer) {
+    auto bytes = static_cast<const char*>(data);
+    static_cast<std::string*>(buffer) -> append(bytes, size);
+    return 0;
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string ScriptCache::GetCachePath(const std::string& sourcePath) {
+    return (std::filesystem::path(SCRIPT_CACHE_DIRECTORY) / std::filesystem::path(sourcePath).stem()).string() + ".luac";
+}
+
+bool ScriptCache::Compile(lua_State* L, const std::string& sourcePath, const std::string& source, std::string& error) {
+    auto start = std::chrono::steady_clock::now();
+    std::string chunkName = "@" + sourcePath;
+    if (luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+        error = lua_tostring(L, -1);
+        lua_pop(L, 1);
+        return false;
+    }
+    double parseMilliseconds = MillisecondsSince(start);
+
+    // Keep the debug information, so errors in cached scripts still name the line
+    std::string bytecode;
+    lua_dump(L, WriteBytecode, &bytecode, 0);
+
+    ScriptCacheHeader header;
+    header.sourceHash = HashSource(source);
+    header.luaVersion = LUA_VERSION_NUM;
+    header.parseMicroseconds = static_cast<uint32_t>(parseMilliseconds * 1000.0);
+
+    // Written aside and renamed, so a reader never sees half a cache file
+    std::string cachePath = GetCachePath(sourcePath);
+    std::string temporaryPath = cachePath + ".tmp";
+    std::error_code fileError;
+    std::filesystem::create_directories(SCRIPT_CACHE_DIRECTORY, fileError);
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        Logger::Warn("Could not write the script cache {}", cachePath);
+        return true;
+    }
+    bool isWritten = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(bytecode.data(), 1, bytecode.size(), file) == bytecode.size();
+    isWritten = fclose(file) == 0 && isWritten;
+    if (isWritten) std::filesystem::rename(temporaryPath, cachePath, fileError);
+    if (!isWritten || fileError) {
+        Logger::Warn("Could not write the script cache {}", cachePath);
+        std::filesystem::remove(temporaryPath, fileError);
+    }
+
+    Logger::Log("Compiled {} in {} ms, {} bytes of bytecode", sourcePath, parseMilliseconds, bytecode.size());
+    return true;
+}
+
+bool ScriptCache::CompileFile(lua_State* L, const std::string& sourcePath, std::string& error) {
+    std::string source;
+    if (!ReadFile(sourcePath, source)) {
+        error = "cannot open " + sourcePath;
+        return false;
+    }
+    if (!Compile(L, sourcePath, source, error)) return false;
+    lua_pop(L, 1);
+    return true;
+}
+
+bool ScriptCache::RunFile(sol::state& lua, const std::string& sourcePath, std::string& error) {
+    lua_State* L = lua.lua_state();
+    std::string source;
+    if (!ReadFile(sourcePath, source)) {
+        error = "cannot open " + sourcePath;
+        return false;
+    }
+
+    // Use the cache if it was compiled from this exact source by this Lua version
+    auto start = std::chrono::steady_clock::now();
+    bool isCached = false;
+    std::string cache;
+    ScriptCacheHeader header;
+    if (ReadFile(GetCachePath(sourcePath), cache) && cache.size() > sizeof(header)) {
+        memcpy(&header, cache.data(), sizeof(header));
+        bool isValid = header.magic == SCRIPT_CACHE_MAGIC && header.version == SCRIPT_CACHE_VERSION &&
+            header.luaVersion == LUA_VERSION_NUM && header.sourceHash == HashSource(source);
+        std::string chunkName = "@" + sourcePath;
+        if (isValid && luaL_loadbufferx(L, cache.data() + sizeof(header), cache.size() - sizeof(header), chunkName.c_str(), "b") == LUA_OK) {
+            isCached = true;
+        } else if (isValid) {
+            lua_pop(L, 1);
+        }
+        if (!isCached) Logger::Warn("Script cache of {} is stale, loading the source", sourcePath);
+    }
+
+    if (isCached) {
+        Logger::Log("Loaded {} from the script cache in {} ms, parsing the source took {} ms", sourcePath, MillisecondsSince(start), header.parseMicroseconds / 1000.0);
+    } else if (!Compile(L, sourcePath, source, error)) {
+        return false;
+    }
+
+    if (lua_pcall(L, 0, 0, 0) != LUA_OK) {
+        // A script may raise any value, not only a string
+        error = luaL_tolstring(L, -1, nullptr);
+        lua_pop(L, 2);
+        return false;
+    }
+    return true;
+}
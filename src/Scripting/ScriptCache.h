@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <sol/sol.hpp>
+
+const uint32_t SCRIPT_CACHE_MAGIC = 0x4342554c;
+// Bump when the cache file layout changes
+const uint32_t SCRIPT_CACHE_VERSION = 1;
+const char* const SCRIPT_CACHE_DIRECTORY = "./assets/scripts/cache";
+
+// Written in front of the bytecode, the cache is only valid for the exact source and Lua version
+struct ScriptCacheHeader {
+    uint32_t magic = SCRIPT_CACHE_MAGIC;
+    uint32_t version = SCRIPT_CACHE_VERSION;
+    uint64_t sourceHash = 0;
+    uint32_t luaVersion = 0;
+    // How long compiling the source took, reported next to the cached load time
+    uint32_t parseMicroseconds = 0;
+};
+
+// Compiled Lua bytecode of scripts, stored next to them in SCRIPT_CACHE_DIRECTORY
+// Level scripts are mostly large tables, so loading precompiled bytecode skips most of the work.
+// Cache files are keyed by a hash of the source: a stale or unreadable cache falls back to the
+// source, which is then compiled and cached again.
+class ScriptCache {
+    private:
+        static std::string GetCachePath(const std::string& sourcePath);
+        // Compile the source into the function on top of the stack and write its bytecode to the cache
+        static bool Compile(lua_State* L, const std::string& sourcePath, const std::string& source, std::string& error);
+
+    public:
+        // Run the script, from the cache when it is valid
+        static bool RunFile(sol::state& lua, const std::string& sourcePath, std::string& error);
+        // Compile the script and write its cache without running it
+        static bool CompileFile(lua_State* L, const std::string& sourcePath, std::string& error);
+};
@@ -0,0 +1,58 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Logger/Logger.h"
+#include "../Game/Game.h"
+#include "./World.h"
+
+// Headless batch simulation: runs N independent worlds on N threads at uncapped speed
+// Usage: ./engine-simulate [--worlds N] [--ticks T] [--level L] [--step MS]
+int main(int argc, char* argv[]) {
+    int numWorlds = std::max(1u, std::thread::hardware_concurrency());
+    int numTicks = 10000;
+    int level = 1;
+    int stepMilliseconds = MS_PER_FRAME;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string argument = argv[i];
+        if (argument == "--worlds") numWorlds = std::max(1, std::stoi(argv[i + 1]));
+        else if (argument == "--ticks") numTicks = std::stoi(argv[i + 1]);
+        else if (argument == "--level") level = std::stoi(argv[i + 1]);
+        else if (argument == "--step") stepMilliseconds = std::stoi(argv[i + 1]);
+        else Logger::Warn("Unknown command line option: {}", argument);
+    }
+
+    // Levels are loaded one after another: loading logs and writes the shared map size
+    std::vector<std::unique_ptr<World>> worlds;
+    for (int i = 0; i < numWorlds; i++) {
+        worlds.push_back(std::make_unique<World>());
+        worlds.back() -> Setup(level);
+    }
+
+    Logger::Log("Running {} worlds for {} ticks each", numWorlds, numTicks);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (auto& world: worlds) {
+        threads.emplace_back([&world, numTicks, stepMilliseconds]() {
+            for (int tick = 0; tick < numTicks; tick++) world -> Step(stepMilliseconds);
+        });
+    }
+    for (auto& thread: threads) thread.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t totalTicks = 0;
+    for (auto& world: worlds) totalTicks += world -> GetNumTicks();
+
+    Logger::Log(
+        "Simulated {} ticks in {} s: {} ticks per second ({} per world)",
+        totalTicks, seconds, static_cast<uint64_t>(totalTicks / seconds), static_cast<uint64_t>(totalTicks / seconds / numWorlds)
+    );
+    // Worlds log on the way out too
+    worlds.clear();
+    Logger::Shutdown();
+    return 0;
+}
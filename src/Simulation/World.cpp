@@ -0,0 +1,40 @@
+#include "../Game/LevelLoader.h"
+#include "../Game/GameSystems.h"
+#include "../Memory/FrameArena.h"
+#include "../Scripting/LuaBindings.h"
+#include "./World.h"
+
+World::World() {
+    camera = {0, 0, 0, 0};
+
+    // A null renderer makes the asset store skip images and fonts
+    assetStore = std::make_unique<AssetStore>(nullptr);
+    registry = std::make_unique<Registry>();
+    eventBus = std::make_unique<EventBus>();
+    navGrid = std::make_unique<NavGrid>();
+    tileLayer = std::make_unique<TileLayer>();
+}
+
+void World::Setup(int level) {
+    GameSystems::Add(registry);
+    clock.MakeCurrent();
+
+    LevelLoader loader;
+    lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::coroutine);
+    LuaBindings::Register(lua, registry);
+    lua_gc(lua.lua_state(), LUA_GCSTOP, 0);
+    loader.LoadLevel(lua, registry, assetStore, navGrid, tileLayer, nullptr, level);
+    // Process the entities created by the level
+    registry -> Update();
+}
+
+void World::Step(uint32_t milliseconds) {
+    // The thread running this world may have stepped another one before
+    clock.MakeCurrent();
+    clock.Advance(milliseconds);
+
+    GameSystems::Update(registry, eventBus, navGrid, camera, lua, milliseconds / 1000.0);
+    // Each simulation thread has its own arena
+    FrameArena::Current().Reset();
+    numTicks++;
+}
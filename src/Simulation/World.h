@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <sol/sol.hpp>
+#include <SDL2/SDL.h>
+
+#include "../ECS/ECS.h"
+#include "../Clock/Clock.h"
+#include "../EventBus/EventBus.h"
+#include "../AssetStore/AssetStore.h"
+#include "../Navigation/NavGrid.h"
+#include "../Renderer/TileLayer.h"
+
+// A self-contained game simulation without window, renderer or audio
+// Each world owns its registry, Lua state and clock, so many worlds can run
+// side by side on different threads.
+class World {
+    private:
+        Clock clock;
+        sol::state lua;
+        SDL_Rect camera;
+        uint64_t numTicks = 0;
+
+        std::unique_ptr<Registry> registry;
+        std::unique_ptr<AssetStore> assetStore;
+        std::unique_ptr<EventBus> eventBus;
+        std::unique_ptr<NavGrid> navGrid;
+        std::unique_ptr<TileLayer> tileLayer;
+
+    public:
+        World();
+        ~World() = default;
+
+        // Add the game systems and load a level script (assets are skipped)
+        void Setup(int level);
+        // Advance the simulation by a fixed step, on the calling thread
+        void Step(uint32_t milliseconds);
+
+        uint64_t GetNumTicks() const { return numTicks; }
+        const std::unique_ptr<Registry>& GetRegistry() const { return registry; }
+};
@@ -1,26 +1,89 @@
 #pragma once
 
-#include <SDL2/SDL.h>
-
+#include <memory>
+#include <algorithm>
 #include "../ECS/ECS.h"
+#include "../Clock/Clock.h"
+#include "../EventBus/EventBus.h"
+#include "../Events/AnimationEvent.h"
+#include "../Animation/AnimationLibrary.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/AnimationComponent.h"
+
+// Plays the clips of its library on every animated entity
+// The clock is read once per update and every entity is advanced by the same elapsed time. Most
+// entities only add it to their frame time; the sprite is touched when the frame changes.
 class AnimationSystem: public System{
+    private:
+        AnimationLibrary library;
+        uint32_t lastTicks = 0;
+        bool isStarted = false;
+
+        // Step to the frame after the current one, false if the clip stays where it is
+        static bool NextFrame(AnimationComponent& animation, const AnimationClip& clip) {
+            int lastFrame = clip.numFrames - 1;
+            switch (clip.mode) {
+                case AnimationMode::LOOP:
+                    animation.frame = animation.frame < lastFrame ? animation.frame + 1 : 0;
+                    return true;
+                case AnimationMode::ONCE:
+                    if (animation.frame >= lastFrame) return false;
+                    animation.frame++;
+                    return true;
+                case AnimationMode::PING_PONG:
+                    if (lastFrame == 0) return false;
+                    if (animation.frame >= lastFrame) animation.isReversed = true;
+                    if (animation.frame == 0) animation.isReversed = false;
+                    animation.frame += animation.isReversed ? -1 : 1;
+                    return true;
+            }
+            return false;
+        }
+
     public:
         AnimationSystem(){
             RequireComponent<SpriteComponent>();
             RequireComponent<AnimationComponent>();
         }
 
-        void Update(){
+        AnimationLibrary& GetLibrary() { return library; }
+
+        void Update(std::unique_ptr<EventBus>& eventBus){
+            uint32_t now = Clock::Now();
+            uint32_t elapsed = isStarted ? now - lastTicks : 0;
+            lastTicks = now;
+            isStarted = true;
+
             for (auto entity: GetSystemEntities()){
                 auto& animation = entity.GetComponent<AnimationComponent>();
-                auto& sprite = entity.GetComponent<SpriteComponent>();
-                
-                // Calculate current frame based on how long the animation has been running, framerate, and the number of frames in the animation
-                animation.currentFrame = ((SDL_GetTicks() - animation.startTime) * animation.frameRateSpeed / 1000) % animation.numFrames;
-                // Change the source rectangle of the sprite component based on current frame and sprite width
-                sprite.srcRect.x = animation.currentFrame * sprite.width;
+                if (!library.IsValid(animation.clip)) continue;
+                const AnimationClip& clip = library.GetClip(animation.clip);
+                // A clip switched to with its phase kept may be shorter
+                if (animation.frame >= clip.numFrames) animation.frame = clip.numFrames - 1;
+
+                uint32_t time = animation.frameTime + elapsed;
+                // Whole cycles of a loop end where they started; their events are skipped
+                if (clip.mode == AnimationMode::LOOP && time >= clip.duration) time %= clip.duration;
+
+                bool isRectDue = false;
+                while (true) {
+                    const AnimationFrame& frame = library.GetFrame(clip, animation.frame);
+                    if (animation.isFrameEntered) {
+                        animation.isFrameEntered = false;
+                        isRectDue = true;
+                        if (frame.event != NO_ANIMATION_EVENT) eventBus -> EmitEvent<AnimationEvent>(entity, library.GetEventName(frame.event));
+                    }
+                    if (time < frame.duration) break;
+                    if (!NextFrame(animation, clip)) {
+                        time = frame.duration;
+                        break;
+                    }
+                    time -= frame.duration;
+                    animation.isFrameEntered = true;
+                }
+                animation.frameTime = time;
+
+                if (isRectDue) entity.GetComponent<SpriteComponent>().srcRect = library.GetFrame(clip, animation.frame).rect;
             }
         }
 };
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <deque>
+#include <queue>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <sol/sol.hpp>
+
+#include "../ECS/ECS.h"
+#include "../Clock/Clock.h"
+#include "../Logger/Logger.h"
+#include "../EventBus/EventBus.h"
+#include "../Events/CollisionEvent.h"
+#include "../Events/AnimationEvent.h"
+
+// What a behaviour yields to the scheduler, see the Lua wrappers below
+enum BehaviourWait {
+    BEHAVIOUR_WAIT_MILLISECONDS = 1,
+    BEHAVIOUR_WAIT_FRAMES,
+    BEHAVIOUR_WAIT_EVENT
+};
+
+// Lua side of the scheduler, run once per Lua state
+static const char* behaviourScript = R"(
+function wait(seconds) return coroutine.yield(1, math.floor(seconds * 1000 + 0.5)) end
+function wait_frames(frames) return coroutine.yield(2, frames) end
+function wait_event(name) return coroutine.yield(3, name) end
+)";
+
+struct Behaviour {
+    // Unique for the lifetime of the system; 0 marks a free slot
+    int id = 0;
+    sol::thread thread;
+    sol::coroutine coroutine;
+    // Entity the behaviour belongs to, it stops when the entity dies; id -1 for level behaviours
+    EntityHandle entity;
+    // Event being waited for, -1 if none
+    int waitEvent = -1;
+    // Counts the event waits, a waiter entry only wakes the wait it was filed for
+    uint32_t waitSerial = 0;
+    // Has been resumed at least once, the first resume passes the entity to the function
+    bool isStarted = false;
+    // Inside its coroutine; stopping it then is deferred until it yields
+    bool isRunning = false;
+    bool isStopped = false;
+};
+
+// A sleeping behaviour, woken up once the clock (or frame counter) reaches due
+// Entries for event waits hold the wait's serial in due instead.
+struct BehaviourTimer {
+    uint32_t due;
+    int slot;
+    int behaviourId;
+    bool operator >(const BehaviourTimer& timer) const { return due > timer.due; }
+};
+
+using BehaviourTimerQueue = std::priority_queue<BehaviourTimer, std::vector<BehaviourTimer>, std::greater<BehaviourTimer>>;
+
+// Runs Lua coroutines that sleep on the game clock, on frame counts or on events:
+//     start_behaviour(function(entity)
+//         while true do
+//             set_velocity(entity.id, 50, 0)
+//             wait(2)
+//             wait_event("collision")
+//             wait_frames(10)
+//         end
+//     end, registry:entity(id))
+// Sleeping behaviours sit in timer queues and event wait lists, so a frame only resumes the ones that are due.
+class BehaviourSystem: public System {
+    private:
+        // A deque, so behaviours started from inside a running one don't move it
+        std::deque<Behaviour> behaviours;
+        std::vector<int> freeSlots;
+        // Slot by behaviour id
+        std::unordered_map<int, int> slotsById;
+        // Slots of the behaviours of each entity, by entity id
+        std::unordered_multimap<int, int> slotsByEntity;
+        int nextBehaviourId = 1;
+
+        BehaviourTimerQueue clockTimers;
+        BehaviourTimerQueue frameTimers;
+        uint32_t frame = 0;
+
+        // Event ids by name; collision is raised by the collision system, the others by emit_event and animation frames
+        std::unordered_map<std::string, int> eventIds;
+        int collisionEventId;
+        // Level behaviours waiting for each event [index = event id]
+        std::vector<std::vector<BehaviourTimer>> eventWaiters;
+        // Entity behaviours waiting for each event, woken by emit_event [index = event id]
+        std::vector<std::vector<BehaviourTimer>> entityEventWaiters;
+        // The same entity behaviours by entity id, woken by their own entity's animation frames
+        std::unordered_multimap<int, BehaviourTimer> animationWaiters;
+        // Behaviours of an entity waiting for it to collide, by entity id
+        std::unordered_multimap<int, BehaviourTimer> collisionWaiters;
+        // Ready to be resumed this frame, with the entity that was collided with (id -1 if none)
+        std::vector<std::pair<BehaviourTimer, EntityHandle>> ready;
+        std::vector<std::pair<BehaviourTimer, EntityHandle>> resuming;
+
+        Registry* registry = nullptr;
+
+        int GetEventId(const std::string& name) {
+            auto eventId = eventIds.find(name);
+            if (eventId != eventIds.end()) return eventId -> second;
+            eventIds.emplace(name, eventWaiters.size());
+            eventWaiters.emplace_back();
+            entityEventWaiters.emplace_back();
+            return eventWaiters.size() - 1;
+        }
+
+        bool IsCurrent(const BehaviourTimer& timer) const {
+            return behaviours[timer.slot].id == timer.behaviourId;
+        }
+
+        // Still in the event wait the entry was filed for
+        bool IsWaiting(const BehaviourTimer& timer, int eventId) const {
+            const Behaviour& behaviour = behaviours[timer.slot];
+            return behaviour.id == timer.behaviourId && behaviour.waitEvent == eventId && behaviour.waitSerial == timer.due;
+        }
+
+        // Drop the entries of waits that are over now and then, for events that are rarely emitted
+        void FileWaiter(std::vector<BehaviourTimer>& waiters, const BehaviourTimer& timer, int eventId) {
+            if (waiters.size() >= 64 && (waiters.size() & (waiters.size() - 1)) == 0) {
+                std::erase_if(waiters, [this, eventId](const BehaviourTimer& waiter) { return !IsWaiting(waiter, eventId); });
+            }
+            waiters.push_back(timer);
+        }
+
+        void Free(int slot) {
+            int entityId = behaviours[slot].entity.id;
+            if (entityId >= 0) {
+                auto entitySlots = slotsByEntity.equal_range(entityId);
+                for (auto entitySlot = entitySlots.first; entitySlot != entitySlots.second; entitySlot++) {
+                    if (entitySlot -> second != slot) continue;
+                    slotsByEntity.erase(entitySlot);
+                    break;
+                }
+            }
+            slotsById.erase(behaviours[slot].id);
+            behaviours[slot] = Behaviour();
+            freeSlots.push_back(slot);
+        }
+
+        // Resume with the given arguments and file the behaviour under whatever it yields next
+        template <typename ...TArgs>
+        void Resume(int slot, TArgs&& ...args) {
+            Behaviour& behaviour = behaviours[slot];
+            if (behaviour.entity.id >= 0 && !registry -> IsValid(behaviour.entity)) {
+                Free(slot);
+                return;
+            }
+
+            behaviour.waitEvent = -1;
+            behaviour.isStarted = true;
+            behaviour.isRunning = true;
+            sol::protected_function_result result = behaviour.coroutine(std::forward<TArgs>(args)...);
+            behaviour.isRunning = false;
+            if (behaviour.isStopped) {
+                Free(slot);
+                return;
+            }
+            if (result.status() != sol::call_status::yielded) {
+                if (!result.valid()) {
+                    sol::error error = result;
+                    Logger::Err("Error in behaviour {}: {}", behaviour.id, error.what());
+                }
+                Free(slot);
+                return;
+            }
+
+            BehaviourTimer timer = {0, slot, behaviour.id};
+            int wait = result.return_count() >= 2 ? result.get<int>(0) : 0;
+            if (wait == BEHAVIOUR_WAIT_MILLISECONDS) {
+                timer.due = Clock::Now() + std::max(result.get<int>(1), 0);
+                clockTimers.push(timer);
+            } else if (wait == BEHAVIOUR_WAIT_FRAMES) {
+                timer.due = frame + std::max(result.get<int>(1), 1);
+                frameTimers.push(timer);
+            } else if (wait == BEHAVIOUR_WAIT_EVENT) {
+                behaviour.waitEvent = GetEventId(result.get<std::string>(1));
+                timer.due = ++behaviour.waitSerial;
+                if (behaviour.entity.id < 0) {
+                    FileWaiter(eventWaiters[behaviour.waitEvent], timer, behaviour.waitEvent);
+                } else if (behaviour.waitEvent == collisionEventId) {
+                    collisionWaiters.emplace(behaviour.entity.id, timer);
+                } else {
+                    FileWaiter(entityEventWaiters[behaviour.waitEvent], timer, behaviour.waitEvent);
+                    // Waits of the entity woken by emit_event are still filed here, drop them
+                    auto waiters = animationWaiters.equal_range(behaviour.entity.id);
+                    for (auto waiter = waiters.first; waiter != waiters.second;) {
+                        const BehaviourTimer& entry = waiter -> second;
+                        int entryEvent = behaviours[entry.slot].waitEvent;
+                        waiter = entryEvent >= 0 && IsWaiting(entry, entryEvent) ? std::next(waiter) : animationWaiters.erase(waiter);
+                    }
+                    animationWaiters.emplace(behaviour.entity.id, timer);
+                }
+            } else {
+                // A plain coroutine.yield(): resume next frame
+                timer.due = frame + 1;
+                frameTimers.push(timer);
+            }
+        }
+
+        void PopDue(BehaviourTimerQueue& timers, uint32_t now) {
+            while (!timers.empty() && timers.top().due <= now) {
+                if (IsCurrent(timers.top())) resuming.push_back({timers.top(), EntityHandle()});
+                timers.pop();
+            }
+        }
+
+        // Once: the wait is over even if the behaviour is filed under the event twice
+        void Wake(const BehaviourTimer& timer, int eventId, EntityHandle other) {
+            if (!IsWaiting(timer, eventId)) return;
+            behaviours[timer.slot].waitEvent = -1;
+            ready.push_back({timer, other});
+        }
+
+    public:
+        BehaviourSystem() {
+            collisionEventId = GetEventId("collision");
+        }
+
+        // Install the Lua functions of the scheduler
+        void Register(sol::state& lua, const std::unique_ptr<Registry>& registry) {
+            this -> registry = registry.get();
+            lua.script(behaviourScript);
+            lua.set_function("start_behaviour", [this](sol::function function, sol::optional<EntityHandle> entity) {
+                return Start(function, entity ? *entity : EntityHandle());
+            });
+            lua.set_function("stop_behaviour", [this](int behaviourId) {
+                Stop(behaviourId);
+            });
+            lua.set_function("emit_event", [this](const std::string& name) {
+                Emit(name);
+            });
+        }
+
+        // Start a behaviour, it first runs in the next update, once the entity's components are all in place
+        int Start(const sol::function& function, EntityHandle entity = EntityHandle()) {
+            int slot;
+            if (freeSlots.empty()) {
+                slot = behaviours.size();
+                behaviours.emplace_back();
+            } else {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+
+            Behaviour& behaviour = behaviours[slot];
+            behaviour.id = nextBehaviourId++;
+            behaviour.entity = entity;
+            behaviour.thread = sol::thread::create(function.lua_state());
+            behaviour.coroutine = sol::coroutine(behaviour.thread.state(), function);
+            slotsById.emplace(behaviour.id, slot);
+            if (entity.id >= 0) slotsByEntity.emplace(entity.id, slot);
+            ready.push_back({{0, slot, behaviour.id}, EntityHandle()});
+            return behaviour.id;
+        }
+
+        void Stop(int behaviourId) {
+            auto slot = slotsById.find(behaviourId);
+            if (slot == slotsById.end()) return;
+            if (behaviours[slot -> second].isRunning) {
+                behaviours[slot -> second].isStopped = true;
+            } else {
+                Free(slot -> second);
+            }
+        }
+
+        // Wake up the behaviours waiting for this event, they resume in the next update
+        void Emit(const std::string& name) {
+            auto eventId = eventIds.find(name);
+            if (eventId == eventIds.end()) return;
+            for (auto& timer: eventWaiters[eventId -> second]) Wake(timer, eventId -> second, EntityHandle());
+            eventWaiters[eventId -> second].clear();
+            for (auto& timer: entityEventWaiters[eventId -> second]) Wake(timer, eventId -> second, EntityHandle());
+            entityEventWaiters[eventId -> second].clear();
+        }
+
+        // The entity's behaviours stop with it, even the ones waiting for something that never comes
+        // Every entity is in this system, it requires no component.
+        void OnEntityRemoved(Entity entity) override {
+            int entityId = entity.GetId();
+            collisionWaiters.erase(entityId);
+            animationWaiters.erase(entityId);
+            auto entitySlots = slotsByEntity.equal_range(entityId);
+            if (entitySlots.first == entitySlots.second) return;
+            std::vector<int> slots;
+            for (auto entitySlot = entitySlots.first; entitySlot != entitySlots.second; entitySlot++) slots.push_back(entitySlot -> second);
+            for (int slot: slots) {
+                if (behaviours[slot].isRunning) {
+                    behaviours[slot].isStopped = true;
+                } else {
+                    Free(slot);
+                }
+            }
+        }
+
+        int GetNumBehaviours() const {
+            return slotsById.size();
+        }
+
+        void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
+            eventBus -> SubscribeToEvent<CollisionEvent>(this, &BehaviourSystem::OnCollision);
+            eventBus -> SubscribeToEvent<AnimationEvent>(this, &BehaviourSystem::OnAnimationEvent);
+        }
+
+        // Frame events of animation clips can be waited for by name: they wake the behaviours of the
+        // animated entity, then the level behaviours, and resume them with the entity
+        void OnAnimationEvent(AnimationEvent& event) {
+            auto eventId = eventIds.find(event.name);
+            if (eventId == eventIds.end()) return;
+            EntityHandle handle = registry -> GetHandle(event.entity);
+            auto waiters = animationWaiters.equal_range(handle.id);
+            for (auto waiter = waiters.first; waiter != waiters.second;) {
+                const BehaviourTimer& timer = waiter -> second;
+                Wake(timer, eventId -> second, handle);
+                // Keep the waits for other events
+                int waitEvent = behaviours[timer.slot].waitEvent;
+                if (waitEvent >= 0 && IsWaiting(timer, waitEvent)) {
+                    waiter++;
+                } else {
+                    waiter = animationWaiters.erase(waiter);
+                }
+            }
+            for (auto& timer: eventWaiters[eventId -> second]) Wake(timer, eventId -> second, handle);
+            eventWaiters[eventId -> second].clear();
+        }
+
+        void OnCollision(CollisionEvent& event) {
+            EntityHandle handles[2] = {registry -> GetHandle(event.a), registry -> GetHandle(event.b)};
+            for (int i = 0; i < 2; i++) {
+                auto waiters = collisionWaiters.equal_range(handles[i].id);
+                for (auto waiter = waiters.first; waiter != waiters.second; waiter++) Wake(waiter -> second, collisionEventId, handles[1 - i]);
+                collisionWaiters.erase(waiters.first, waiters.second);
+            }
+            // Level behaviours waiting for any collision
+            for (auto& timer: eventWaiters[collisionEventId]) Wake(timer, collisionEventId, handles[1]);
+            eventWaiters[collisionEventId].clear();
+        }
+
+        void Update() {
+            frame++;
+            // Only what is due now: behaviours that wait again while resuming are filed for later frames
+            resuming.clear();
+            PopDue(clockTimers, Clock::Now());
+            PopDue(frameTimers, frame);
+            resuming.insert(resuming.end(), ready.begin(), ready.end());
+            ready.clear();
+
+            for (auto& [timer, other]: resuming) {
+                // Stopped by a behaviour resumed earlier
+                if (!IsCurrent(timer)) continue;
+                const Behaviour& behaviour = behaviours[timer.slot];
+                if (!behaviour.isStarted && behaviour.entity.id >= 0) {
+                    Resume(timer.slot, behaviour.entity);
+                } else if (other.id >= 0) {
+                    Resume(timer.slot, other);
+                } else {
+                    Resume(timer.slot);
+                }
+            }
+        }
+};
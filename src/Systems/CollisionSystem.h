@@ -1,17 +1,31 @@
 #pragma once
 
-#include <SDL2/SDL.h>
-
-#include <vector>
+#include <memory_resource>
 #include "../ECS/ECS.h"
+#include "../Memory/FrameArena.h"
 #include "../EventBus/EventBus.h"
 #include "../Events/CollisionEvent.h"
+#include "../Telemetry/Telemetry.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
 
+// Axis-aligned box in world pixels
+struct BoundingBox {
+    int x;
+    int y;
+    int w;
+    int h;
+
+    // Same rule as SDL_HasIntersection: empty boxes never intersect, touching edges don't count
+    bool Intersects(const BoundingBox& other) const {
+        if (w <= 0 || h <= 0 || other.w <= 0 || other.h <= 0) return false;
+        return x < other.x + other.w && other.x < x + w && y < other.y + other.h && other.y < y + h;
+    }
+};
+
 struct EntityBox {
-    shared_ptr<Entity> entity;
-    SDL_Rect box;
+    Entity entity;
+    BoundingBox box;
 };
 
 class CollisionSystem: public System{
@@ -22,9 +36,11 @@ class CollisionSystem: public System{
         }
 
         void Update(unique_ptr<EventBus>& eventBus){
-            // Create a vector to cache bounding boxes
-            vector<Entity> entities = GetSystemEntities();
-            vector<EntityBox> entityBoxes(entities.size());
+            // Cache bounding boxes in frame scratch memory
+            // Collision handlers only mark entities for removal, so the system's list doesn't change while looping
+            const vector<Entity>& entities = GetSystemEntities();
+            std::pmr::vector<EntityBox> entityBoxes(&FrameArena::Current());
+            entityBoxes.reserve(entities.size());
 
             // Loop over system entities
             for (auto aEntity: entities){
@@ -34,22 +50,18 @@ class CollisionSystem: public System{
                 aCollider.isColliding = false;
 
                 // Create a bounding box for the current entity
-                SDL_Rect aBox {
+                BoundingBox aBox {
                     (int)aTransform.position.x + ((int)aCollider.offset.x * (int)aTransform.scale.x),
                     (int)aTransform.position.y + ((int)aCollider.offset.y * (int)aTransform.scale.y),
                     aCollider.width * (int)aTransform.scale.x,
                     aCollider.height * (int)aTransform.scale.y
                 };
                 
-                EntityBox aEntityBox;
-                aEntityBox.entity = make_shared<Entity>(aEntity);
-                aEntityBox.box = aBox;
-                
                 // Loop over the vector of boxes - check for collisions and log
-                for (auto bEntityBox: entityBoxes){
-                    SDL_Rect bBox = bEntityBox.box;
-                    if (SDL_HasIntersection(&aBox, &bBox)){
-                        Entity bEntity = *bEntityBox.entity;
+                Telemetry::Add(TELEMETRY_COLLISION_PAIRS, entityBoxes.size());
+                for (const auto& bEntityBox: entityBoxes){
+                    if (aBox.Intersects(bEntityBox.box)){
+                        Entity bEntity = bEntityBox.entity;
                         auto& bCollider = bEntity.GetComponent<BoxColliderComponent>();
                         aCollider.isColliding = true;
                         bCollider.isColliding = true;
@@ -60,7 +72,7 @@ class CollisionSystem: public System{
                 }
                
                 // Push the bounding box into the cache vector
-                entityBoxes.push_back(aEntityBox);
+                entityBoxes.push_back({aEntity, aBox});
             }
         }
 };
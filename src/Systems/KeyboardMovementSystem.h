@@ -7,9 +7,25 @@
 #include "../Components/SpriteComponent.h"
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/KeyboardControlComponent.h"
+#include "../Components/AnimationComponent.h"
 
 
 class KeyboardMovementSystem: public System {
+    private:
+        // Play the entity's clip for the facing, or pick the row of a four way sprite sheet when it has no clips
+        // An entity playing a clip without one for the facing keeps it: its frames say which row to draw.
+        static void Face(Entity entity, SpriteComponent& sprite, AnimationFacing facing) {
+            if (entity.HasComponent<AnimationComponent>()) {
+                auto& animation = entity.GetComponent<AnimationComponent>();
+                if (animation.facingClips[facing] != NO_ANIMATION_CLIP) {
+                    animation.Play(animation.facingClips[facing], true);
+                    return;
+                }
+                if (animation.clip != NO_ANIMATION_CLIP) return;
+            }
+            sprite.srcRect.y = sprite.height * facing;
+        }
+
     public:
         KeyboardMovementSystem() {
             RequireComponent<SpriteComponent>();
@@ -30,25 +46,25 @@ class KeyboardMovementSystem: public System {
                 
                 if (event.key == "Up") {
                     rigidBody.velocity.y = -keyboardControl.speed;
-                    sprite.srcRect.y = sprite.height * 0;
+                    Face(entity, sprite, FACING_UP);
                     sprite.direction = event.key;
                 }
                 
                 if (event.key == "Right") {
                     rigidBody.velocity.x = keyboardControl.speed;
-                    sprite.srcRect.y = sprite.height * 1;
+                    Face(entity, sprite, FACING_RIGHT);
                     sprite.direction = event.key;
                 }
                 
                 if (event.key == "Down") {
                     rigidBody.velocity.y = keyboardControl.speed;
-                    sprite.srcRect.y = sprite.height * 2;
+                    Face(entity, sprite, FACING_DOWN);
                     sprite.direction = event.key;
                 }
                 
                 if (event.key == "Left") {
                     rigidBody.velocity.x = -keyboardControl.speed;
-                    sprite.srcRect.y = sprite.height * 3;
+                    Face(entity, sprite, FACING_LEFT);
                     sprite.direction = event.key;
                 }
             }
@@ -1,23 +1,42 @@
 #pragma once
 
-#include <SDL2/SDL.h>
-
+#include <memory>
+#include <vector>
 #include "../ECS/ECS.h"
+#include "../Clock/Clock.h"
+#include "../Clock/TimerWheel.h"
 #include "../Components/LifecycleComponent.h"
 
+// Kills entities once their time to live is up
+// Each entity's deadline goes into a timer wheel when it joins the system and leaves it when the
+// entity does, so a frame only touches the entities that expire in it. Recycled projectiles come
+// back through OnEntityAdded with their new start time.
 class LifecycleSystem: public System {
+    private:
+        TimerWheel expirations;
+        // Ids handed out by the wheel this frame, kept to reuse the allocation
+        std::vector<int> expired;
+
     public:
-        LifecycleSystem() {
-            RequireComponent<LifecycleComponent>();
+        LifecycleSystem() { RequireComponent<LifecycleComponent>(); }
+
+        void OnEntityAdded(Entity entity) override {
+            const auto& lifecycle = entity.GetComponent<LifecycleComponent>();
+            expirations.Schedule(entity.GetId(), lifecycle.startTime + lifecycle.timeToLive);
         }
 
-        void Update() {
-            for (auto entity: GetSystemEntities()){
-                auto lifecycle = entity.GetComponent<LifecycleComponent>();
-                if((int)(SDL_GetTicks() - lifecycle.startTime) >= lifecycle.timeToLive) {
-                   entity.Kill(); 
-                }     
+        void OnEntityRemoved(Entity entity) override {
+            expirations.Cancel(entity.GetId());
+        }
+
+        void Update(std::unique_ptr<Registry>& registry) {
+            expired.clear();
+            expirations.Advance(Clock::Now(), expired);
+            for (int entityId: expired) {
+                // Systems reach the registry through the entity when it is removed
+                Entity entity(entityId);
+                entity.registry = registry.get();
+                entity.Kill();
             }
         }
 };
-
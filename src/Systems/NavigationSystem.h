@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+
+#include "../ECS/ECS.h"
+#include "../Navigation/NavGrid.h"
+#include "../Navigation/FlowField.h"
+#include "../Navigation/AStar.h"
+#include "../Components/NavigationComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+
+// Maximum number of cells a flow field expands per frame while following a moving target
+const int FLOW_FIELD_CELL_BUDGET = 4096;
+
+class NavigationSystem: public System {
+    private:
+        // One flow field per target tag, shared by every entity chasing that target
+        vector<string> flowFieldTargets;
+        vector<FlowField> flowFields;
+        AStar pathfinder;
+
+        int GetFlowFieldId(const string& targetTag, const NavGrid& navGrid) {
+            for (int i = 0; i < static_cast<int>(flowFieldTargets.size()); i++) {
+                if (flowFieldTargets[i] == targetTag) return i;
+            }
+            flowFieldTargets.push_back(targetTag);
+            flowFields.emplace_back(navGrid);
+            return flowFields.size() - 1;
+        }
+
+    public:
+        NavigationSystem() {
+            RequireComponent<NavigationComponent>();
+            RequireComponent<TransformComponent>();
+            RequireComponent<RigidBodyComponent>();
+        }
+
+        // One-off path query between two world positions, for entities that don't follow a flow field
+        bool FindPath(const NavGrid& navGrid, glm::vec2 from, glm::vec2 to, vector<glm::ivec2>& path) {
+            return pathfinder.FindPath(navGrid, navGrid.WorldToCell(from), navGrid.WorldToCell(to), path);
+        }
+
+        void Update(const std::unique_ptr<Registry>& registry, const std::unique_ptr<NavGrid>& navGrid) {
+            if (navGrid -> IsEmpty()) return;
+
+            // Attach new entities to the flow field of their target
+            for (auto entity: GetSystemEntities()) {
+                auto& navigation = entity.GetComponent<NavigationComponent>();
+                if (navigation.flowFieldId == -1) navigation.flowFieldId = GetFlowFieldId(navigation.targetTag, *navGrid);
+            }
+
+            // Follow each target: a field is only recomputed when its target changes cells
+            for (int i = 0; i < static_cast<int>(flowFields.size()); i++) {
+                if (!registry -> HasEntityWithTag(flowFieldTargets[i])) continue;
+                const auto target = registry -> GetEntityByTag(flowFieldTargets[i]);
+                const auto targetTransform = target.GetComponent<TransformComponent>();
+
+                flowFields[i].SetTarget(navGrid -> WorldToCell(targetTransform.position));
+                // Nothing to steer by yet, so the first field is computed in one go
+                if (!flowFields[i].IsReady()) flowFields[i].Complete();
+                else flowFields[i].Update(FLOW_FIELD_CELL_BUDGET);
+            }
+
+            // Steer every entity along its field
+            for (auto entity: GetSystemEntities()) {
+                const auto& navigation = entity.GetComponent<NavigationComponent>();
+                const auto& transform = entity.GetComponent<TransformComponent>();
+                auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+
+                glm::vec2 direction = flowFields[navigation.flowFieldId].GetDirection(transform.position);
+                rigidBody.velocity = direction * static_cast<float>(navigation.speed);
+            }
+        }
+};
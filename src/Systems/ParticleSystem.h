@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <SDL2/SDL.h>
+#include "../ECS/ECS.h"
+#include "../Telemetry/Telemetry.h"
+#include "../Particles/ParticlePool.h"
+#include "../Renderer/SpriteBatcher.h"
+#include "../Renderer/RenderSnapshot.h"
+#include "../AssetStore/AssetStore.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/ParticleEmitterComponent.h"
+
+// Runs the particle pool: emitter components feed it, and its particles are drawn as quads of the sprite batcher
+// Particles are simulated and captured on the simulation thread like everything else; drawing writes
+// each definition's particles straight into its batch, so a texture's particles take one draw call.
+class ParticleSystem: public System {
+    private:
+        ParticlePool pool;
+
+    public:
+        ParticleSystem() {
+            RequireComponent<TransformComponent>();
+            RequireComponent<ParticleEmitterComponent>();
+        }
+
+        ParticlePool& GetPool() { return pool; }
+
+        void Update(double deltaTime) {
+            for (auto entity: GetSystemEntities()) {
+                auto& emitter = entity.GetComponent<ParticleEmitterComponent>();
+                if (!emitter.isEmitting || emitter.definition < 0) continue;
+                emitter.pending += emitter.rate * deltaTime;
+                int numParticles = static_cast<int>(emitter.pending);
+                if (numParticles == 0) continue;
+                emitter.pending -= numParticles;
+                const auto& transform = entity.GetComponent<TransformComponent>();
+                pool.Emit(emitter.definition, transform.position.x + emitter.offset.x, transform.position.y + emitter.offset.y, numParticles);
+            }
+            pool.Update(deltaTime);
+            Telemetry::Set(TELEMETRY_PARTICLES, pool.GetCount());
+        }
+
+        void Capture(RenderSnapshot& snapshot, const SDL_Rect& camera) {
+            pool.Capture(snapshot, camera);
+        }
+
+        // Add the snapshot's particles to the batcher, before it is flushed
+        void Draw(SpriteBatcher& batcher, std::unique_ptr<AssetStore>& assetStore, const RenderSnapshot& snapshot) {
+            int numDefinitions = std::min<int>(pool.GetNumDefinitions(), static_cast<int>(snapshot.particleRanges.size()) - 1);
+            for (int definitionId = 0; definitionId < numDefinitions; definitionId++) {
+                uint32_t first = snapshot.particleRanges[definitionId];
+                uint32_t last = snapshot.particleRanges[definitionId + 1];
+                if (first == last) continue;
+
+                const ParticleEmitterDefinition& definition = pool.GetDefinition(definitionId);
+                const TextureRegion& texture = assetStore -> GetTexture(definition.assetId);
+                SDL_Vertex* vertices = batcher.AddQuads(definition.layer, texture.texture, last - first);
+                if (!vertices) continue;
+
+                // Texture coordinates of the definition's rectangle in the atlas page, the same for every particle
+                int pageWidth;
+                int pageHeight;
+                SDL_QueryTexture(texture.texture, nullptr, nullptr, &pageWidth, &pageHeight);
+                SDL_Rect srcRect = definition.srcRect.w > 0 ? definition.srcRect : SDL_Rect{0, 0, texture.rect.w, texture.rect.h};
+                float u0 = static_cast<float>(texture.rect.x + srcRect.x) / pageWidth;
+                float v0 = static_cast<float>(texture.rect.y + srcRect.y) / pageHeight;
+                float u1 = static_cast<float>(texture.rect.x + srcRect.x + srcRect.w) / pageWidth;
+                float v1 = static_cast<float>(texture.rect.y + srcRect.y + srcRect.h) / pageHeight;
+
+                for (uint32_t i = first; i < last; i++) {
+                    const ParticleInstance& particle = snapshot.particles[i];
+                    float halfSize = particle.size * 0.5f;
+                    float left = particle.x - halfSize;
+                    float top = particle.y - halfSize;
+                    float right = particle.x + halfSize;
+                    float bottom = particle.y + halfSize;
+                    vertices[0] = {{left, top}, particle.color, {u0, v0}};
+                    vertices[1] = {{right, top}, particle.color, {u1, v0}};
+                    vertices[2] = {{right, bottom}, particle.color, {u1, v1}};
+                    vertices[3] = {{left, bottom}, particle.color, {u0, v1}};
+                    vertices += 4;
+                }
+            }
+        }
+};
@@ -1,8 +1,8 @@
 #pragma once
 
-#include <SDL2/SDL.h>
-
+#include <unordered_map>
 #include "../ECS/ECS.h"
+#include "../Clock/Clock.h"
 #include "../EventBus/EventBus.h"
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/BoxColliderComponent.h"
@@ -13,14 +13,73 @@
 #include "../Components/DamageComponent.h"
 
 #include "../Events/KeyPressedEvent.h"
+#include "./RenderSystem.h"
 
+// Fires projectiles from emitters, recycling them through a pool per emitter
+// A pooled projectile that dies (lifetime, off the map, hit) is deactivated rather than destroyed,
+// and firing it again only resets its position, velocity and start time.
 class ProjectileEmitSystem: public System {
+    private:
+        // Recycle pool of each emitter, by emitter entity id
+        std::unordered_map<int, int> projectilePools;
+
+        static Entity CreateProjectile(Registry* registry, const ProjectileEmitterComponent& projectileEmitter, glm::vec2 position, glm::vec2 velocity) {
+            Entity projectile = registry -> CreateEntity();
+            projectile.Group("projectiles");
+            projectile.AddComponent<TransformComponent>(position, glm::vec2(1.0, 1.0), 0.0);
+            projectile.AddComponent<RigidBodyComponent>(velocity);
+            projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, registry -> GetSystem<RenderSystem>().GetLayerIndex("projectiles"));
+            projectile.AddComponent<BoxColliderComponent>(4, 4, projectileEmitter.projectileDamageLayer);
+            projectile.AddComponent<LifecycleComponent>(projectileEmitter.projectileDuration);
+            projectile.AddComponent<DamageComponent>(projectileEmitter.projectileDamage);
+            return projectile;
+        }
+
+        // The emitter's pool, -1 without one
+        int GetProjectilePool(Entity emitter) const {
+            auto pool = projectilePools.find(emitter.GetId());
+            return pool != projectilePools.end() ? pool -> second : -1;
+        }
+
+        void Fire(Entity emitter, const ProjectileEmitterComponent& projectileEmitter, glm::vec2 position, glm::vec2 velocity) {
+            Registry* registry = emitter.registry;
+            Entity projectile(-1);
+            if (registry -> TakeFromRecyclePool(GetProjectilePool(emitter), projectile)) {
+                projectile.registry = registry;
+                projectile.GetComponent<TransformComponent>().position = position;
+                projectile.GetComponent<RigidBodyComponent>().velocity = velocity;
+                projectile.GetComponent<LifecycleComponent>().startTime = Clock::Now();
+            } else {
+                CreateProjectile(registry, projectileEmitter, position, velocity);
+            }
+        }
+
     public:
         ProjectileEmitSystem() {
             RequireComponent<ProjectileEmitterComponent>();
             RequireComponent<TransformComponent>();
         }
-        
+
+        // Fill the emitter's pool with inactive projectiles now, so firing never creates them
+        void OnEntityAdded(Entity entity) override {
+            const auto& projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
+            if (projectileEmitter.projectilePoolSize <= 0 || projectilePools.count(entity.GetId())) return;
+
+            Registry* registry = entity.registry;
+            int poolId = registry -> CreateRecyclePool();
+            for (int i = 0; i < projectileEmitter.projectilePoolSize; i++) {
+                registry -> AddToRecyclePool(CreateProjectile(registry, projectileEmitter, glm::vec2(0), glm::vec2(0)), poolId);
+            }
+            projectilePools.emplace(entity.GetId(), poolId);
+        }
+
+        // The projectiles in flight die for real, the ones waiting in the pool go now
+        void OnEntityRemoved(Entity entity) override {
+            auto pool = projectilePools.find(entity.GetId());
+            if (pool == projectilePools.end()) return;
+            entity.registry -> ReleaseRecyclePool(pool -> second);
+            projectilePools.erase(pool);
+        }
          
         void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) {
             eventBus -> SubscribeToEvent<KeyPressedEvent>(this, &ProjectileEmitSystem::onKeyPress);
@@ -30,7 +89,7 @@ class ProjectileEmitSystem: public System {
             if (event.key == "Space") {
                 for (auto entity: GetSystemEntities()) {
                     auto& projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
-                    uint32_t now = SDL_GetTicks();
+                    uint32_t now = Clock::Now();
                     if (!projectileEmitter.isAuto && (int)(now - projectileEmitter.lastFiredTime) > projectileEmitter.projectileFrequency) {
                         const auto transform = entity.GetComponent<TransformComponent>();
                         glm::vec2 projectilePosition = transform.position;
@@ -53,16 +112,7 @@ class ProjectileEmitSystem: public System {
                             }
                             
                         }
-                        // Add a new projectile entity to the registry
-                        Entity projectile = entity.registry -> CreateEntity();
-                        projectile.Group("projectiles");
-                        projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                        projectile.AddComponent<RigidBodyComponent>(projectileVelocity);
-                        projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                        projectile.AddComponent<BoxColliderComponent>(4, 4, projectileEmitter.projectileDamageLayer);
-                        // Set something on the projectile emitter component to control lifecycle instead of hardcoding
-                        projectile.AddComponent<LifecycleComponent>(projectileEmitter.projectileDuration);
-                        projectile.AddComponent<DamageComponent>(projectileEmitter.projectileDamage);
+                        Fire(entity, projectileEmitter, projectilePosition, projectileVelocity);
 
                         projectileEmitter.lastFiredTime = now;
                     }
@@ -74,7 +124,7 @@ class ProjectileEmitSystem: public System {
             for (auto entity: GetSystemEntities()){
                 auto& projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
                 const auto transform = entity.GetComponent<TransformComponent>();
-                uint32_t now = SDL_GetTicks();
+                uint32_t now = Clock::Now();
                 // Check if it's time to emit a new projectile
                 if (projectileEmitter.isAuto && (int)(now - projectileEmitter.lastFiredTime) > projectileEmitter.projectileFrequency) {
                     glm::vec2 projectilePosition = transform.position;
@@ -84,16 +134,7 @@ class ProjectileEmitSystem: public System {
                         projectilePosition.y += (transform.scale.y * sprite.height / 2);
 
                     }
-                    // Add a new projectile entity to the registry
-                    Entity projectile = registry -> CreateEntity();
-                    projectile.Group("projectiles");
-                    projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
-                    projectile.AddComponent<RigidBodyComponent>(projectileEmitter.projectileVelocity);
-                    projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                    projectile.AddComponent<BoxColliderComponent>(4, 4, projectileEmitter.projectileDamageLayer);
-                    // Set something on the projectile emitter component to control lifecycle instead of hardcoding
-                    projectile.AddComponent<LifecycleComponent>(projectileEmitter.projectileDuration);
-                    projectile.AddComponent<DamageComponent>(projectileEmitter.projectileDamage);
+                    Fire(entity, projectileEmitter, projectilePosition, projectileEmitter.projectileVelocity);
 
                     projectileEmitter.lastFiredTime = now;
                     
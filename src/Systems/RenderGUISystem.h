@@ -1,6 +1,12 @@
 #pragma once
 
 #include "../ECS/ECS.h"
+#include "../Profiler/AllocationTracker.h"
+#include "../Memory/FrameArena.h"
+#include "../Logger/Logger.h"
+#include "./ScriptSystem.h"
+#include "./RenderSystem.h"
+#include <cfloat>
 #include <glm/glm.hpp>
 #include <imgui/imgui.h>
 #include <imgui/imgui_impl_sdl2.h>
@@ -68,7 +74,7 @@ class RenderGUISystem: public System {
                     if (useProjectileEmitter) {
                         enemy.AddComponent<ProjectileEmitterComponent>(glm::vec2(projectileXVelocity, projectileYVelocity), projectileFrequency, projectileDuration, projectileDamage);
                     }
-                    enemy.AddComponent<SpriteComponent>(sprites[sprite_index], 32, 32, 2);
+                    enemy.AddComponent<SpriteComponent>(sprites[sprite_index], 32, 32, registry -> GetSystem<RenderSystem>().GetLayerIndex("units"));
                     enemy.AddComponent<RigidBodyComponent>(glm::vec2(enemyXVelocity, enemyYVelocity));
                     enemy.AddComponent<BoxColliderComponent>(32, 32, 2);
                     enemy.AddComponent<HealthComponent>(enemyHealth);
@@ -76,9 +82,102 @@ class RenderGUISystem: public System {
                 }
             }
             ImGui::End();
+
+            if (AllocationTracker::IsEnabled()) RenderAllocations();
+            RenderFrameArena();
+            RenderLog();
+            RenderScripts(registry);
+            RenderSpriteBatches(registry);
             
             ImGui::Render();
             ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData());
         }
 
+        // Draw calls the sprite batcher made last frame
+        void RenderSpriteBatches(const std::unique_ptr<Registry>& registry) {
+            const SpriteBatchStats& stats = registry -> GetSystem<RenderSystem>().GetStats();
+            if (ImGui::Begin("Sprite batches")) {
+                ImGui::Text("batches: %d", stats.batches);
+                ImGui::Text("quads: %d", stats.quads);
+                ImGui::Text("texture switches: %d", stats.textureSwitches);
+            }
+            ImGui::End();
+        }
+
+        // Time spent in each behaviour script
+        void RenderScripts(const std::unique_ptr<Registry>& registry) {
+            if (ImGui::Begin("Scripts")) {
+                if (ImGui::BeginTable("scripts", 4)) {
+                    ImGui::TableSetupColumn("script");
+                    ImGui::TableSetupColumn("entities");
+                    ImGui::TableSetupColumn("last frame (ms)");
+                    ImGui::TableSetupColumn("average (ms)");
+                    ImGui::TableHeadersRow();
+                    for (auto& script: registry -> GetSystem<ScriptSystem>().GetScripts()) {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%s", script.name.c_str());
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%d", script.numEntities);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", script.frameTime);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", script.averageTime);
+                    }
+                    ImGui::EndTable();
+                }
+            }
+            ImGui::End();
+        }
+
+        // Recent log messages, newest at the bottom
+        void RenderLog() {
+            static const ImVec4 colors[] = {ImVec4(0.4f, 0.9f, 0.4f, 1.0f), ImVec4(1.0f, 0.9f, 0.3f, 1.0f), ImVec4(1.0f, 0.3f, 0.3f, 1.0f)};
+            if (ImGui::Begin("Log")) {
+                Logger::ForEachHistoryEntry([](const LogEntry& entry) {
+                    ImGui::TextColored(colors[entry.type], "%s", entry.message.c_str());
+                });
+            }
+            ImGui::End();
+        }
+
+        // Scratch memory use of the main thread, to size FRAME_ARENA_DEFAULT_SIZE
+        void RenderFrameArena() {
+            const FrameArena& arena = FrameArena::Current();
+            if (ImGui::Begin("Frame arena")) {
+                ImGui::Text("capacity: %zu bytes", arena.GetCapacity());
+                ImGui::Text("last frame: %zu bytes", arena.GetLastFrameBytes());
+                ImGui::Text("high-water mark: %zu bytes", arena.GetHighWaterMark());
+                ImGui::Text("frames overflowed: %d", arena.GetNumOverflowFrames());
+            }
+            ImGui::End();
+        }
+
+        // Last frame's heap allocations per scope and a graph of the recent frames
+        void RenderAllocations() {
+            if (ImGui::Begin("Allocations")) {
+                ImGui::PlotLines("allocations per frame", AllocationTracker::GetHistory(), ALLOCATION_HISTORY_FRAMES, AllocationTracker::GetHistoryOffset(), nullptr, 0.0f, FLT_MAX, ImVec2(0, 80));
+                if (ImGui::BeginTable("allocations", 4)) {
+                    ImGui::TableSetupColumn("scope");
+                    ImGui::TableSetupColumn("allocations");
+                    ImGui::TableSetupColumn("bytes");
+                    ImGui::TableSetupColumn("frees");
+                    ImGui::TableHeadersRow();
+                    for (int i = 0; i < AllocationTracker::GetNumScopes(); i++) {
+                        const AllocationStats& stats = AllocationTracker::GetLastFrame(i);
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%s", AllocationTracker::GetScopeName(i));
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", static_cast<unsigned long long>(stats.allocations));
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", static_cast<unsigned long long>(stats.bytes));
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", static_cast<unsigned long long>(stats.frees));
+                    }
+                    ImGui::EndTable();
+                }
+            }
+            ImGui::End();
+        }
 };
@@ -1,30 +1,49 @@
 #pragma once
 
+#include <charconv>
+#include <string_view>
 #include <SDL2/SDL.h>
 #include <glm/glm.hpp>
 
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Telemetry/Telemetry.h"
 #include "../Components/HealthComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Renderer/SpriteBatcher.h"
+#include "../Renderer/RenderSnapshot.h"
 
 
+// Health bars, with the percentage drawn from the font's glyph atlas since it changes all the time
 class RenderHealthSystem: public System {
+    private:
+        const std::string fontId = "kitchensink_font";
+        SpriteBatcher textBatcher;
+
     public: 
         RenderHealthSystem() {
             RequireComponent<HealthComponent>();
             RequireComponent<TransformComponent>(); 
         }
 
-        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera){
+        // Copy the health bars into the snapshot, on the simulation thread
+        void Capture(RenderSnapshot& snapshot, const SDL_Rect& camera){
             for (auto entity: GetSystemEntities()){
-                const auto transform = entity.GetComponent<TransformComponent>();
-                const auto health = entity.GetComponent<HealthComponent>();
-               
+                const auto& transform = entity.GetComponent<TransformComponent>();
+                const auto& health = entity.GetComponent<HealthComponent>();
+                HealthInstance& healthBar = snapshot.healthBars.Add();
+                healthBar.position = {(int)transform.position.x - camera.x, (int)transform.position.y - 10 - camera.y};
+                healthBar.healthPercentage = health.healthPercentage;
+            }
+        }
+
+        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, const RenderSnapshot& snapshot){
+            const GlyphAtlas* glyphAtlas = assetStore -> GetGlyphAtlas(fontId);
+            for (const auto& health: snapshot.healthBars){
                 // Draw a filled rectangle for the health bar
                 SDL_Rect healthBar = {
-                    (int)transform.position.x - camera.x,
-                    (int)transform.position.y - 10 - camera.y,
+                    health.position.x,
+                    health.position.y,
                     32 * health.healthPercentage / 100,
                     5
                 };
@@ -33,42 +52,36 @@ class RenderHealthSystem: public System {
                 switch (health.healthPercentage) {
                     case 71 ... 100:
                         SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-                        healthBarColor = {0, 255, 0};
+                        healthBarColor = {0, 255, 0, 255};
                         break;
                     case 31 ... 70:
                         SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-                        healthBarColor = {255, 255, 0};
+                        healthBarColor = {255, 255, 0, 255};
                         break;
                     case 0 ... 30:
                         SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-                        healthBarColor = {255, 0, 0};
+                        healthBarColor = {255, 0, 0, 255};
                         break;
                 }
                 
                 SDL_RenderFillRect(renderer, &healthBar);
+                Telemetry::Add(TELEMETRY_DRAW_CALLS);
                 
-                // Draw the health percentage as text 
-                std::string healthText = std::to_string(health.healthPercentage) + "%";
-
-                SDL_Surface* surface = TTF_RenderText_Blended(assetStore -> GetFont("kitchensink_font"), healthText.c_str(), healthBarColor); 
-                SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-                SDL_FreeSurface(surface);
-
-                int healthTextWidth = 0;
-                int healthTextHeight = 0;
-
-                SDL_QueryTexture(texture, NULL, NULL, &healthTextWidth, &healthTextHeight);
-
-                SDL_Rect destRect = {
-                    (int)transform.position.x - camera.x + (32 * health.healthPercentage / 100) + 10,
-                    (int)transform.position.y - 10 - camera.y,
-                    healthTextWidth,
-                    healthTextHeight
-                };
-                
-                SDL_RenderCopy(renderer, texture, NULL, &destRect);
-                SDL_DestroyTexture(texture);
-
+                // Draw the health percentage as text, formatted without allocating
+                if (!glyphAtlas) continue;
+                char healthText[8];
+                char* textEnd = std::to_chars(healthText, healthText + sizeof(healthText) - 1, health.healthPercentage).ptr;
+                *textEnd++ = '%';
+                glyphAtlas -> Draw(
+                    textBatcher,
+                    0,
+                    std::string_view(healthText, textEnd - healthText),
+                    health.position.x + (32 * health.healthPercentage / 100) + 10,
+                    health.position.y,
+                    healthBarColor
+                );
             }
+
+            textBatcher.Flush(renderer);
         }
 };
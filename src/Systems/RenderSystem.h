@@ -1,70 +1,225 @@
 #pragma once
 
+#include <string>
+#include <vector>
+#include <string_view>
 #include <algorithm>
 #include <SDL2/SDL.h>
 #include "../ECS/ECS.h"
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../AssetStore/AssetStore.h"
+#include "../Renderer/SpriteBatcher.h"
+#include "../Renderer/RenderSnapshot.h"
+
+// Which sprites a render call draws: world sprites follow the camera, fixed ones (HUD) don't
+enum RenderPass {
+    RENDER_ALL,
+    RENDER_WORLD,
+    RENDER_FIXED
+};
+
+struct RenderLayer {
+    std::string name;
+    // Draw the layer's sprites by the bottom edge, top of the screen first, so lower sprites overlap higher ones
+    bool isYSorted = false;
+    // Sprites of the layer, in draw order once y-sorted
+    std::vector<Entity> sprites;
+};
+
+// Used when the level doesn't declare render_layers, in draw order
+const char* const DEFAULT_RENDER_LAYERS[] = {"tiles", "ground", "units", "air", "projectiles", "hud"};
+
+// Draws sprites through a SpriteBatcher: one draw call per (layer, texture) instead of one per sprite,
+// or per run of a texture in y-sorted layers
+// Every layer keeps a bucket of its sprites, updated as sprites come, go or change layer,
+// so drawing them in order never sorts the whole scene.
 class RenderSystem: public System{
+    private:
+        SpriteBatcher batcher;
+        std::vector<RenderLayer> layers;
+        // Layer whose bucket holds each entity, by entity id, -1 for none
+        std::vector<int> entityLayers;
+        // Where each entity is in its layer's bucket, by entity id
+        std::vector<int> entitySlots;
+        // Bottom edges of a y-sorted layer's sprites, sorted along with them
+        std::vector<float> sortKeys;
+
+        int ClampLayer(int layer) const {
+            return std::clamp(layer, 0, static_cast<int>(layers.size()) - 1);
+        }
+
+        void AddToLayer(Entity entity, int layer) {
+            int entityId = entity.GetId();
+            if (entityId >= static_cast<int>(entityLayers.size())) {
+                entityLayers.resize(entityId + 1, -1);
+                entitySlots.resize(entityId + 1, -1);
+            }
+            entityLayers[entityId] = layer;
+            entitySlots[entityId] = layers[layer].sprites.size();
+            layers[layer].sprites.push_back(entity);
+        }
+
+        void RemoveFromLayer(Entity entity) {
+            int entityId = entity.GetId();
+            if (entityId >= static_cast<int>(entityLayers.size()) || entityLayers[entityId] < 0) return;
+            // The last sprite takes its place: sprites of a layer that isn't y-sorted have no order among
+            // themselves, and y-sorted layers are sorted again before they are drawn
+            auto& sprites = layers[entityLayers[entityId]].sprites;
+            int slot = entitySlots[entityId];
+            sprites[slot] = sprites.back();
+            entitySlots[sprites[slot].GetId()] = slot;
+            sprites.pop_back();
+            entityLayers[entityId] = -1;
+        }
+
+        // Insertion sort by bottom edge: stable, and close to linear since sprites move little between frames
+        void SortLayerByY(RenderLayer& layer) {
+            auto& sprites = layer.sprites;
+            sortKeys.resize(sprites.size());
+            for (size_t i = 0; i < sprites.size(); i++) {
+                const auto& transform = sprites[i].GetComponent<TransformComponent>();
+                const auto& sprite = sprites[i].GetComponent<SpriteComponent>();
+                sortKeys[i] = transform.position.y + sprite.height * transform.scale.y;
+            }
+            for (size_t i = 1; i < sprites.size(); i++) {
+                float key = sortKeys[i];
+                Entity entity = sprites[i];
+                size_t j = i;
+                for (; j > 0 && sortKeys[j - 1] > key; j--) {
+                    sortKeys[j] = sortKeys[j - 1];
+                    sprites[j] = sprites[j - 1];
+                }
+                sortKeys[j] = key;
+                sprites[j] = entity;
+            }
+            for (size_t i = 0; i < sprites.size(); i++) entitySlots[sprites[i].GetId()] = i;
+        }
+
     public: 
         RenderSystem(){
             RequireComponent<SpriteComponent>();
             RequireComponent<TransformComponent>();
+            for (auto name: DEFAULT_RENDER_LAYERS) layers.push_back({name, false, {}});
+        }
+
+        // Batches, quads and texture switches of the last frame
+        const SpriteBatchStats& GetStats() const {
+            return batcher.GetStats();
+        }
+
+        // Quads added before Update are drawn with the sprites, in their layer
+        SpriteBatcher& GetBatcher() {
+            return batcher;
+        }
+
+        const std::vector<RenderLayer>& GetLayers() const {
+            return layers;
+        }
+
+        // Index of the named layer, -1 if there is no such layer
+        int GetLayerIndex(std::string_view name) const {
+            for (int i = 0; i < static_cast<int>(layers.size()); i++) {
+                if (layers[i].name == name) return i;
+            }
+            return -1;
+        }
+
+        // Replace the layers (names and sorting, in draw order); sprites already added keep their layer index
+        void SetLayers(const std::vector<RenderLayer>& definitions) {
+            if (definitions.empty()) return;
+            for (int i = 0; i < static_cast<int>(layers.size()); i++) batcher.SetLayerOrdered(i, false);
+            layers.clear();
+            for (auto& definition: definitions) {
+                // A y-sorted layer is drawn in its sorted order, whatever the textures
+                batcher.SetLayerOrdered(layers.size(), definition.isYSorted);
+                layers.push_back({definition.name, definition.isYSorted, {}});
+            }
+            std::fill(entityLayers.begin(), entityLayers.end(), -1);
+            for (auto entity: GetSystemEntities()) {
+                auto& sprite = entity.GetComponent<SpriteComponent>();
+                sprite.layer = ClampLayer(sprite.layer);
+                AddToLayer(entity, sprite.layer);
+            }
+        }
+
+        // Move a sprite to another layer, drawn last in it until the next y-sort
+        void SetSpriteLayer(Entity entity, int layer) {
+            if (!entity.HasComponent<SpriteComponent>()) return;
+            auto& sprite = entity.GetComponent<SpriteComponent>();
+            sprite.layer = ClampLayer(layer);
+            int entityId = entity.GetId();
+            // Not in the system yet: it is bucketed with its new layer when it's added
+            if (entityId >= static_cast<int>(entityLayers.size()) || entityLayers[entityId] < 0) return;
+            if (entityLayers[entityId] == sprite.layer) return;
+            RemoveFromLayer(entity);
+            AddToLayer(entity, sprite.layer);
+        }
+
+        void OnEntityAdded(Entity entity) override {
+            auto& sprite = entity.GetComponent<SpriteComponent>();
+            sprite.layer = ClampLayer(sprite.layer);
+            AddToLayer(entity, sprite.layer);
+        }
+
+        void OnEntityRemoved(Entity entity) override {
+            RemoveFromLayer(entity);
         }
         
-        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, SDL_Rect& camera){
-           // Create a vector of sprite and transform components for all entities
-            struct RenderableEntity {
-                TransformComponent transformComponent; 
-                SpriteComponent spriteComponent;
-            };
-            
-            std::vector<RenderableEntity> renderableEntities;
-            std::sort(GetSystemEntities().begin(), GetSystemEntities().end(), [](Entity a, Entity b){
-                return a.GetComponent<SpriteComponent>().zIndex < b.GetComponent<SpriteComponent>().zIndex;        
-            });
-           
-            // Loop all entities that the system is interested in
-            for (auto entity: GetSystemEntities()){
-                const auto transform = entity.GetComponent<TransformComponent>();
-                const auto sprite = entity.GetComponent<SpriteComponent>();
-                bool isEntityOutsideCameraView = {
-                    transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
-                    transform.position.x > camera.x + camera.w ||
-                    transform.position.y + (transform.scale.y * sprite.height)< camera.y ||
-                    transform.position.y > camera.y + camera.h    
-                };
-
-                if (isEntityOutsideCameraView && !sprite.isFixed) continue;
-
-                SDL_Texture* texture = assetStore -> GetTexture(sprite.assetId);   
-               
-                // Set source rectangle of our original sprite texture
-                SDL_Rect srcRect = sprite.srcRect;
-                // Look into SDL_QueryTexture to handle automatically
-
-                // Set destination rectangle with the x, y position to be rendered
-                // Base on the camera position
-                SDL_Rect destRect = {
-                    static_cast<int>(transform.position.x - (sprite.isFixed ? 0 : camera.x)),
-                    static_cast<int>(transform.position.y - (sprite.isFixed ? 0 : camera.y)),
-                    static_cast<int>(sprite.width * transform.scale.x),
-                    static_cast<int>(sprite.height * transform.scale.y)
-                };
-
-                SDL_RenderCopyEx(
-                            renderer,
-                            texture, 
-                            &srcRect,
-                            &destRect,
-                            transform.rotation,
-                            NULL,
-                            sprite.flip
-                        );    
+        // Copy the sprites the camera sees into the snapshot, layer by layer, on the simulation thread
+        void Capture(RenderSnapshot& snapshot, const SDL_Rect& camera){
+            for (int layerIndex = 0; layerIndex < static_cast<int>(layers.size()); layerIndex++) {
+                RenderLayer& layer = layers[layerIndex];
+                if (layer.isYSorted) SortLayerByY(layer);
+                for (auto entity: layer.sprites){
+                    const auto& transform = entity.GetComponent<TransformComponent>();
+                    const auto& sprite = entity.GetComponent<SpriteComponent>();
 
+                    bool isEntityOutsideCameraView = {
+                        transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
+                        transform.position.x > camera.x + camera.w ||
+                        transform.position.y + (transform.scale.y * sprite.height)< camera.y ||
+                        transform.position.y > camera.y + camera.h    
+                    };
 
+                    if (isEntityOutsideCameraView && !sprite.isFixed) continue;
+
+                    SpriteInstance& instance = snapshot.sprites.Add();
+                    instance.assetId = sprite.assetId;
+                    instance.srcRect = sprite.srcRect;
+                    // Set destination rectangle with the x, y position to be rendered
+                    // Base on the camera position, snapped to whole pixels like before batching
+                    instance.destRect = {
+                        static_cast<float>(static_cast<int>(transform.position.x - (sprite.isFixed ? 0 : camera.x))),
+                        static_cast<float>(static_cast<int>(transform.position.y - (sprite.isFixed ? 0 : camera.y))),
+                        static_cast<float>(static_cast<int>(sprite.width * transform.scale.x)),
+                        static_cast<float>(static_cast<int>(sprite.height * transform.scale.y))
+                    };
+                    instance.rotation = transform.rotation;
+                    instance.flip = sprite.flip;
+                    instance.layer = layerIndex;
+                    instance.isFixed = sprite.isFixed;
+                }
             }
+        }
+
+        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, const RenderSnapshot& snapshot, RenderPass pass = RENDER_ALL){
+            // The world (or only) pass starts the frame
+            if (pass != RENDER_FIXED) batcher.ResetStats();
+
+            // Sprites come in layer order, the batcher groups each layer's by texture
+            for (const auto& sprite: snapshot.sprites){
+                if ((pass == RENDER_WORLD && sprite.isFixed) || (pass == RENDER_FIXED && !sprite.isFixed)) continue;
+
+                // The source rectangle is relative to the texture, which is somewhere in an atlas page
+                const TextureRegion& texture = assetStore -> GetTexture(sprite.assetId);
+                SDL_Rect srcRect = sprite.srcRect;
+                srcRect.x += texture.rect.x;
+                srcRect.y += texture.rect.y;
+                batcher.Add(sprite.layer, texture.texture, srcRect, sprite.destRect, sprite.rotation, sprite.flip);
+            }
+
+            batcher.Flush(renderer);
         }  
 
 };
@@ -1,40 +1,58 @@
 #pragma once
 
+#include <vector>
 #include <SDL2/SDL.h>
 
 #include "../ECS/ECS.h"
 #include "../AssetStore/AssetStore.h"
+#include "./RenderSystem.h"
+#include "../Renderer/SpriteBatcher.h"
+#include "../Renderer/RenderSnapshot.h"
 #include "../Components/TextLabelComponent.h"
 
+// Labels are rendered once into the asset store's text cache and drawn as batched quads
 class RenderTextSystem: public System {
+    private:
+        SpriteBatcher batcher;
+        std::vector<SDL_Texture*> destroyedTextures;
+
     public:
         RenderTextSystem() {
             RequireComponent<TextLabelComponent>();
         }
 
-        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, const SDL_Rect& camera) {
+        // Copy the labels into the snapshot, on the simulation thread
+        void Capture(RenderSnapshot& snapshot, const SDL_Rect& camera) {
             for (auto entity: GetSystemEntities()) {
-                const auto textLabel = entity.GetComponent<TextLabelComponent>();
-                
-                SDL_Surface* surface = TTF_RenderText_Blended(assetStore -> GetFont(textLabel.assetId), textLabel.text.c_str(), textLabel.color); 
-
-                SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-                SDL_FreeSurface(surface);
+                const auto& textLabel = entity.GetComponent<TextLabelComponent>();
+                LabelInstance& label = snapshot.labels.Add();
+                label.text = textLabel.text;
+                label.assetId = textLabel.assetId;
+                label.position = {
+                    static_cast<float>(static_cast<int>(textLabel.position.x - (textLabel.isFixed ? 0 : camera.x))),
+                    static_cast<float>(static_cast<int>(textLabel.position.y - (textLabel.isFixed ? 0 : camera.y)))
+                };
+                label.color = textLabel.color;
+                label.isFixed = textLabel.isFixed;
+            }
+        }
 
-                int labelWidth = 0;
-                int labelHeight = 0;
+        void Update(SDL_Renderer* renderer, std::unique_ptr<AssetStore>& assetStore, const RenderSnapshot& snapshot, RenderPass pass = RENDER_ALL) {
+            // The cache keeps every text asked for until the batcher is flushed
+            destroyedTextures.clear();
+            assetStore -> BeginTextFrame(destroyedTextures);
+            for (SDL_Texture* texture: destroyedTextures) batcher.Forget(texture);
+            for (const auto& label: snapshot.labels) {
+                if ((pass == RENDER_WORLD && label.isFixed) || (pass == RENDER_FIXED && !label.isFixed)) continue;
 
-                SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight);
+                const CachedText* text = assetStore -> GetText(label.assetId, label.text, label.color);
+                if (!text) continue;
 
-                SDL_Rect destRect = {
-                    static_cast<int>(textLabel.position.x - (textLabel.isFixed ? 0 : camera.x)),
-                    static_cast<int>(textLabel.position.y - (textLabel.isFixed ? 0 : camera.y)),
-                    labelWidth,
-                    labelHeight,
-                };
-                
-                SDL_RenderCopy(renderer, texture, NULL, &destRect);
-                SDL_DestroyTexture(texture);
+                SDL_Rect srcRect = {0, 0, text -> width, text -> height};
+                SDL_FRect destRect = {label.position.x, label.position.y, static_cast<float>(text -> width), static_cast<float>(text -> height)};
+                batcher.Add(0, text -> texture, srcRect, destRect);
             }
+
+            batcher.Flush(renderer);
         }
 };
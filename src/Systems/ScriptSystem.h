@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <sol/sol.hpp>
+
+#include "../ECS/ECS.h"
+#include "../Logger/Logger.h"
+#include "../Components/ScriptComponent.h"
+
+// Kilobytes of allocation the Lua GC works off per frame
+const int SCRIPT_GC_STEP_KILOBYTES = 64;
+
+struct Script {
+    std::string name;
+    sol::protected_function onUpdate;
+    // Ids of the entities running the script this frame, reused between frames
+    sol::table entities;
+    int numEntities = 0;
+    // Milliseconds spent in on_update, last frame and smoothed
+    double frameTime = 0.0;
+    double averageTime = 0.0;
+};
+
+// Calls each script's on_update(entities, count, delta_time) once per frame for all of its entities,
+// so the cost of entering Lua doesn't grow with the number of scripted entities
+class ScriptSystem: public System {
+    private:
+        std::vector<Script> scripts;
+        // Script id by Lua function
+        std::unordered_map<const void*, int> scriptIds;
+        int gcStepKilobytes = SCRIPT_GC_STEP_KILOBYTES;
+
+    public:
+        ScriptSystem() {
+            RequireComponent<ScriptComponent>();
+        }
+
+        // Id of the script that runs this function, added the first time the function is seen
+        int AddScript(sol::state& lua, const std::string& name, const sol::protected_function& onUpdate) {
+            auto scriptId = scriptIds.find(onUpdate.pointer());
+            if (scriptId != scriptIds.end()) return scriptId -> second;
+
+            Script script;
+            script.name = name;
+            script.onUpdate = onUpdate;
+            script.entities = lua.create_table(64, 0);
+            scripts.push_back(script);
+            scriptIds.emplace(onUpdate.pointer(), scripts.size() - 1);
+            return scripts.size() - 1;
+        }
+
+        void SetGCStepKilobytes(int kilobytes) {
+            gcStepKilobytes = kilobytes;
+        }
+
+        const std::vector<Script>& GetScripts() const {
+            return scripts;
+        }
+
+        void Update(sol::state& lua, double deltaTime) {
+            // Gather the entities of every script
+            for (auto& script: scripts) script.numEntities = 0;
+            for (auto entity: GetSystemEntities()) {
+                int scriptId = entity.GetComponent<ScriptComponent>().scriptId;
+                if (scriptId < 0 || scriptId >= static_cast<int>(scripts.size())) continue;
+                Script& script = scripts[scriptId];
+                script.entities.raw_set(++script.numEntities, entity.GetId());
+            }
+
+            for (auto& script: scripts) {
+                script.frameTime = 0.0;
+                if (script.numEntities == 0) continue;
+                // Cut the array at the current count so ipairs and # stop there
+                script.entities.raw_set(script.numEntities + 1, sol::lua_nil);
+
+                auto start = std::chrono::steady_clock::now();
+                sol::protected_function_result result = script.onUpdate(script.entities, script.numEntities, deltaTime);
+                script.frameTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                script.averageTime += (script.frameTime - script.averageTime) * 0.1;
+
+                if (!result.valid()) {
+                    sol::error error = result;
+                    Logger::Err("Error in script {}: {}", script.name, error.what());
+                }
+            }
+
+            // The automatic collector is stopped, so garbage is collected here in bounded steps
+            lua_gc(lua.lua_state(), LUA_GCSTEP, gcStepKilobytes);
+        }
+};
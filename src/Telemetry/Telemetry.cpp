@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "./Telemetry.h"
+#include "../Logger/Logger.h"
+
+std::atomic<uint64_t> Telemetry::values[TELEMETRY_MAX_VALUES];
+char Telemetry::poolNames[TELEMETRY_MAX_POOLS][TELEMETRY_NAME_LENGTH];
+std::atomic<int> Telemetry::poolNameStates[TELEMETRY_MAX_POOLS];
+TelemetrySegment* Telemetry::segment = nullptr;
+
+static const char* fixedValueNames[TELEMETRY_NUM_FIXED_VALUES] = {
+    "frame",
+    "frame_time_us",
+    "entities",
+    "collision_pairs",
+    "events_dispatched",
+    "draw_calls",
+    "texture_switches",
+    "time_to_first_frame_us",
+    "sprite_quads",
+    "simulation_time_us",
+    "pipeline_overlap_us",
+    "particles"
+};
+
+static bool IsCounter(int value) {
+    return value == TELEMETRY_COLLISION_PAIRS || value == TELEMETRY_EVENTS_DISPATCHED ||
+           value == TELEMETRY_DRAW_CALLS || value == TELEMETRY_TEXTURE_SWITCHES ||
+           value == TELEMETRY_SPRITE_QUADS;
+}
+
+void Telemetry::SetPoolSize(int componentId, const char* componentName, uint64_t size) {
+    if (componentId < 0 || componentId >= TELEMETRY_MAX_POOLS) return;
+    // Pool names never change once set: the first call copies it, and Publish only reads it after that
+    int state = poolNameStates[componentId].load(std::memory_order_acquire);
+    if (state == TELEMETRY_POOL_UNNAMED && poolNameStates[componentId].compare_exchange_strong(state, TELEMETRY_POOL_NAMING, std::memory_order_relaxed)) {
+        snprintf(poolNames[componentId], TELEMETRY_NAME_LENGTH, "pool.%s", componentName);
+        poolNameStates[componentId].store(TELEMETRY_POOL_NAMED, std::memory_order_release);
+    }
+    values[TELEMETRY_NUM_FIXED_VALUES + componentId].store(size, std::memory_order_relaxed);
+}
+
+bool Telemetry::Open() {
+    if (segment) return true;
+
+    int fd = shm_open(TELEMETRY_SEGMENT_NAME, O_CREAT | O_RDWR, 0644);
+    if (fd == -1 || ftruncate(fd, sizeof(TelemetrySegment)) == -1) {
+        Logger::Err("Unable to create telemetry shared memory segment");
+        if (fd != -1) close(fd);
+        return false;
+    }
+    void* memory = mmap(NULL, sizeof(TelemetrySegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        Logger::Err("Unable to map telemetry shared memory segment");
+        return false;
+    }
+
+    segment = static_cast<TelemetrySegment*>(memory);
+    segment -> magic = TELEMETRY_MAGIC;
+    segment -> version = TELEMETRY_VERSION;
+    segment -> sequence.store(0, std::memory_order_relaxed);
+    segment -> numValues = TELEMETRY_MAX_VALUES;
+    Logger::Log("Publishing telemetry to shared memory {}", TELEMETRY_SEGMENT_NAME);
+    return true;
+}
+
+void Telemetry::Close() {
+    if (!segment) return;
+    munmap(segment, sizeof(TelemetrySegment));
+    shm_unlink(TELEMETRY_SEGMENT_NAME);
+    segment = nullptr;
+}
+
+void Telemetry::Publish() {
+    uint64_t snapshot[TELEMETRY_MAX_VALUES];
+    for (int i = 0; i < TELEMETRY_MAX_VALUES; i++) {
+        snapshot[i] = IsCounter(i) ? values[i].exchange(0, std::memory_order_relaxed) : values[i].load(std::memory_order_relaxed);
+    }
+    if (!segment) return;
+
+    // Odd sequence: readers retry until the write below is complete
+    uint32_t sequence = segment -> sequence.load(std::memory_order_relaxed);
+    segment -> sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int i = 0; i < TELEMETRY_NUM_FIXED_VALUES; i++) {
+        strncpy(segment -> names[i], fixedValueNames[i], TELEMETRY_NAME_LENGTH - 1);
+    }
+    for (int i = 0; i < TELEMETRY_MAX_POOLS; i++) {
+        char* name = segment -> names[TELEMETRY_NUM_FIXED_VALUES + i];
+        if (poolNameStates[i].load(std::memory_order_acquire) == TELEMETRY_POOL_NAMED) {
+            memcpy(name, poolNames[i], TELEMETRY_NAME_LENGTH);
+        } else {
+            name[0] = '\0';
+        }
+    }
+    memcpy(segment -> values, snapshot, sizeof(snapshot));
+
+    segment -> sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Fixed counters and gauges, in publishing order
+// Counters accumulate during a frame and restart from zero after each Publish()
+// Gauges hold their last value
+enum TelemetryValue {
+    TELEMETRY_FRAME_NUMBER,
+    TELEMETRY_FRAME_TIME_US,
+    TELEMETRY_ENTITY_COUNT,
+    TELEMETRY_COLLISION_PAIRS,
+    TELEMETRY_EVENTS_DISPATCHED,
+    TELEMETRY_DRAW_CALLS,
+    TELEMETRY_TEXTURE_SWITCHES,
+    TELEMETRY_TIME_TO_FIRST_FRAME_US,
+    TELEMETRY_SPRITE_QUADS,
+    TELEMETRY_SIMULATION_TIME_US,
+    // Time the simulation and the renderer ran at the same time in the last pipelined frame
+    TELEMETRY_PIPELINE_OVERLAP_US,
+    // Live particles, which aren't entities
+    TELEMETRY_PARTICLES,
+    TELEMETRY_NUM_FIXED_VALUES
+};
+
+// Component pool sizes are published after the fixed values, one slot per component type
+const int TELEMETRY_MAX_POOLS = 32;
+const int TELEMETRY_MAX_VALUES = TELEMETRY_NUM_FIXED_VALUES + TELEMETRY_MAX_POOLS;
+const int TELEMETRY_NAME_LENGTH = 32;
+
+const char* const TELEMETRY_SEGMENT_NAME = "/engine-telemetry";
+const uint32_t TELEMETRY_MAGIC = 0x454c4554;
+const uint32_t TELEMETRY_VERSION = 5;
+
+// Layout of the shared memory segment
+// Readers use the sequence number as a seqlock: it is odd while the engine is writing,
+// and a copy is only consistent if the sequence was even and unchanged around it.
+struct TelemetrySegment {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> sequence;
+    uint32_t numValues;
+    char names[TELEMETRY_MAX_VALUES][TELEMETRY_NAME_LENGTH];
+    uint64_t values[TELEMETRY_MAX_VALUES];
+};
+
+enum TelemetryPoolNameState {
+    TELEMETRY_POOL_UNNAMED,
+    TELEMETRY_POOL_NAMING,
+    TELEMETRY_POOL_NAMED
+};
+
+// Lock-free process-wide counters, published once per frame to shared memory
+// Updating a value is a single relaxed atomic operation, so hot paths can count freely;
+// formatting and display happen in a separate reader process (engine-telemetry).
+class Telemetry {
+    private:
+        static std::atomic<uint64_t> values[TELEMETRY_MAX_VALUES];
+        static char poolNames[TELEMETRY_MAX_POOLS][TELEMETRY_NAME_LENGTH];
+        // TELEMETRY_POOL_NAMED once the pool's name is written; pools appear on the simulation thread
+        // while Publish reads the names on the main thread
+        static std::atomic<int> poolNameStates[TELEMETRY_MAX_POOLS];
+        static TelemetrySegment* segment;
+
+    public:
+        static void Add(TelemetryValue counter, uint64_t amount = 1) {
+            values[counter].fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        static void Set(TelemetryValue gauge, uint64_t value) {
+            values[gauge].store(value, std::memory_order_relaxed);
+        }
+
+        static uint64_t Get(TelemetryValue value) {
+            return values[value].load(std::memory_order_relaxed);
+        }
+
+        // Gauge for the number of components in one pool
+        static void SetPoolSize(int componentId, const char* componentName, uint64_t size);
+
+        // Create the shared memory segment; without it Publish() only resets the counters
+        static bool Open();
+        static void Close();
+        // Copy every value into the shared segment and restart the per-frame counters
+        static void Publish();
+};
@@ -0,0 +1,67 @@
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include "../Logger/Logger.h"
+#include "../AssetStore/TextureAtlas.h"
+
+// Packs images into the texture atlas the engine loads instead of the separate images
+// Usage: ./engine-atlas-packer OUTPUT_DIRECTORY IMAGE...
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        Logger::Err("Usage: {} OUTPUT_DIRECTORY IMAGE...", argv[0]);
+        Logger::Shutdown();
+        return 1;
+    }
+    std::string outputDirectory = argv[1];
+
+    TextureAtlasBuilder builder;
+    AtlasIndex index;
+    int numFailed = 0;
+    for (int i = 2; i < argc; i++) {
+        std::string imagePath = AtlasIndex::NormalizePath(argv[i]);
+        AtlasIndexEntry entry = {};
+        SDL_Surface* surface = IMG_Load(argv[i]);
+        if (!surface || !AtlasIndex::GetFileStamp(argv[i], entry.fileSize, entry.modifiedTime)) {
+            Logger::Err("Could not load {}", argv[i]);
+            if (surface) SDL_FreeSurface(surface);
+            numFailed++;
+            continue;
+        }
+        index.entries[imagePath] = entry;
+        builder.Add(imagePath, surface);
+    }
+
+    std::error_code fileError;
+    std::filesystem::create_directories(outputDirectory, fileError);
+    std::vector<SDL_Surface*> pages = builder.Build();
+    for (int page = 0; page < static_cast<int>(pages.size()); page++) {
+        std::string pageFile = "atlas-" + std::to_string(page) + ".png";
+        if (!pages[page] || IMG_SavePNG(pages[page], (outputDirectory + "/" + pageFile).c_str()) != 0) {
+            Logger::Err("Could not write the atlas page {}", pageFile);
+            numFailed++;
+        }
+        index.pageFiles.push_back(pageFile);
+        if (pages[page]) SDL_FreeSurface(pages[page]);
+    }
+    for (auto& image: builder.GetImages()) {
+        index.entries[image.name].page = image.page;
+        index.entries[image.name].rect = image.rect;
+    }
+    // Images that failed to load or convert aren't in the atlas
+    std::erase_if(index.entries, [&builder](const auto& entry) {
+        for (auto& image: builder.GetImages()) {
+            if (image.name == entry.first) return false;
+        }
+        return true;
+    });
+
+    if (!index.Save(outputDirectory + "/" + ATLAS_INDEX_FILE)) {
+        Logger::Err("Could not write the atlas index in {}", outputDirectory);
+        numFailed++;
+    }
+    Logger::Log("Packed {} images into {} pages", index.entries.size(), pages.size());
+    Logger::Shutdown();
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <memory>
+#include <sol/sol.hpp>
+#include "../ECS/ECS.h"
+#include "../Logger/Logger.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Scripting/LuaBindings.h"
+
+// Moves every entity by its velocity from Lua, three ways, and prints the time per frame of each:
+//   tables     components copied into a Lua table per entity and copied back afterwards
+//   ids        one on_update call with the entity ids, components read and written with get_/set_ functions
+//   each_with  registry:each_with, the function works on the pool's components in place
+// Usage: ./engine-script-benchmark [--entities N] [--frames N]
+
+static const char* benchmarkScript = R"(
+function move_tables(bodies, count, delta_time)
+    for i = 1, count do
+        local body = bodies[i]
+        body.x = body.x + body.vx * delta_time
+        body.y = body.y + body.vy * delta_time
+    end
+end
+
+function move_ids(entities, count, delta_time)
+    for i = 1, count do
+        local entity = entities[i]
+        local x, y = get_position(entity)
+        local vx, vy = get_velocity(entity)
+        set_position(entity, x + vx * delta_time, y + vy * delta_time)
+    end
+end
+
+function move_each_with(delta_time)
+    registry:each_with({"transform", "rigidbody"}, function(entity, transform, rigidbody)
+        local position = transform.position
+        local velocity = rigidbody.velocity
+        position.x = position.x + velocity.x * delta_time
+        position.y = position.y + velocity.y * delta_time
+    end)
+end
+)";
+
+const double BENCHMARK_DELTA_TIME = 1.0 / 60.0;
+
+static void ResetPositions(Registry& registry) {
+    int numEntities = registry.GetNumEntities();
+    for (int entityId = 0; entityId < numEntities; entityId++) {
+        Entity entity(entityId);
+        entity.registry = &registry;
+        entity.GetComponent<TransformComponent>().position = glm::vec2(entityId % 100, entityId / 100);
+    }
+}
+
+// Sum of all positions, to check that every way moved the entities the same
+static double SumPositions(Registry& registry) {
+    double sum = 0.0;
+    registry.ForEachComponent<TransformComponent>([&sum](int, const TransformComponent& transform) {
+        sum += transform.position.x + transform.position.y;
+    });
+    return sum;
+}
+
+template <typename TFunction>
+static void Measure(const char* name, Registry& registry, int numFrames, TFunction runFrame) {
+    ResetPositions(registry);
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < numFrames; frame++) runFrame();
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("%-10s %9.3f ms/frame   checksum %.3f\n", name, milliseconds / numFrames, SumPositions(registry));
+}
+
+int main(int argc, char* argv[]) {
+    int numEntities = 10000;
+    int numFrames = 200;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string argument = argv[i];
+        if (argument == "--entities") numEntities = std::stoi(argv[i + 1]);
+        if (argument == "--frames") numFrames = std::stoi(argv[i + 1]);
+    }
+
+    std::unique_ptr<Registry> registry = std::make_unique<Registry>();
+    for (int i = 0; i < numEntities; i++) {
+        Entity entity = registry -> CreateEntity();
+        entity.AddComponent<TransformComponent>();
+        entity.AddComponent<RigidBodyComponent>(glm::vec2(i % 7 - 3, i % 5 - 2));
+    }
+    registry -> Update();
+
+    sol::state lua;
+    lua.open_libraries(sol::lib::base, sol::lib::math);
+    LuaBindings::Register(lua, registry);
+    lua.script(benchmarkScript);
+    printf("%d entities, %d frames\n", numEntities, numFrames);
+
+    sol::protected_function moveTables = lua["move_tables"];
+    Measure("tables", *registry, numFrames, [&]() {
+        sol::table bodies = lua.create_table(numEntities, 0);
+        for (int entityId = 0; entityId < numEntities; entityId++) {
+            Entity entity(entityId);
+            entity.registry = registry.get();
+            const auto& position = entity.GetComponent<TransformComponent>().position;
+            const auto& velocity = entity.GetComponent<RigidBodyComponent>().velocity;
+            bodies[entityId + 1] = lua.create_table_with("x", position.x, "y", position.y, "vx", velocity.x, "vy", velocity.y);
+        }
+        moveTables(bodies, numEntities, BENCHMARK_DELTA_TIME);
+        for (int entityId = 0; entityId < numEntities; entityId++) {
+            Entity entity(entityId);
+            entity.registry = registry.get();
+            sol::table body = bodies[entityId + 1];
+            float x = body["x"];
+            float y = body["y"];
+            entity.GetComponent<TransformComponent>().position = glm::vec2(x, y);
+        }
+    });
+
+    sol::protected_function moveIds = lua["move_ids"];
+    sol::table ids = lua.create_table(numEntities, 0);
+    for (int entityId = 0; entityId < numEntities; entityId++) ids.raw_set(entityId + 1, entityId);
+    Measure("ids", *registry, numFrames, [&]() {
+        moveIds(ids, numEntities, BENCHMARK_DELTA_TIME);
+    });
+
+    sol::protected_function moveEachWith = lua["move_each_with"];
+    Measure("each_with", *registry, numFrames, [&]() {
+        moveEachWith(BENCHMARK_DELTA_TIME);
+    });
+
+    Logger::Shutdown();
+    return 0;
+}
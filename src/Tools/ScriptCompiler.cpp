@@ -0,0 +1,21 @@
+#include <string>
+#include <cstdio>
+#include <sol/sol.hpp>
+#include "../Logger/Logger.h"
+#include "../Scripting/ScriptCache.h"
+
+// Writes the bytecode cache of Lua scripts ahead of time, without running them
+// Usage: ./engine-script-compiler SCRIPT...
+int main(int argc, char* argv[]) {
+    sol::state lua;
+    int numFailed = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string error;
+        if (!ScriptCache::CompileFile(lua.lua_state(), argv[i], error)) {
+            Logger::Err("Could not compile {}: {}", argv[i], error);
+            numFailed++;
+        }
+    }
+    Logger::Shutdown();
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include <deque>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "../Telemetry/Telemetry.h"
+
+// Attaches to the telemetry segment of a running engine and prints its values
+// Usage: ./engine-telemetry [--interval MS] [--graph NAME]
+// With --graph, the history of one value is drawn as a bar chart under the table
+
+struct TelemetrySnapshot {
+    char names[TELEMETRY_MAX_VALUES][TELEMETRY_NAME_LENGTH];
+    uint64_t values[TELEMETRY_MAX_VALUES];
+};
+
+// Copy the segment once the engine isn't writing to it
+static void ReadSnapshot(const TelemetrySegment* segment, TelemetrySnapshot& snapshot) {
+    while (true) {
+        uint32_t before = segment -> sequence.load(std::memory_order_acquire);
+        if (before % 2 == 0) {
+            memcpy(snapshot.names, segment -> names, sizeof(snapshot.names));
+            memcpy(snapshot.values, segment -> values, sizeof(snapshot.values));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (segment -> sequence.load(std::memory_order_relaxed) == before) return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int interval = 500;
+    std::string graphName;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string argument = argv[i];
+        if (argument == "--interval") interval = std::stoi(argv[i + 1]);
+        if (argument == "--graph") graphName = argv[i + 1];
+    }
+
+    int fd = shm_open(TELEMETRY_SEGMENT_NAME, O_RDONLY, 0);
+    if (fd == -1) {
+        fprintf(stderr, "No telemetry segment found, start the engine with --telemetry\n");
+        return 1;
+    }
+    void* memory = mmap(NULL, sizeof(TelemetrySegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        fprintf(stderr, "Unable to map the telemetry segment\n");
+        return 1;
+    }
+
+    const TelemetrySegment* segment = static_cast<const TelemetrySegment*>(memory);
+    if (segment -> magic != TELEMETRY_MAGIC || segment -> version != TELEMETRY_VERSION) {
+        fprintf(stderr, "Telemetry segment has an unknown layout\n");
+        return 1;
+    }
+
+    TelemetrySnapshot snapshot;
+    std::deque<uint64_t> history;
+    const size_t historyLength = 60;
+
+    while (true) {
+        ReadSnapshot(segment, snapshot);
+
+        // Clear the terminal and redraw the table
+        printf("\033[2J\033[H");
+        for (int i = 0; i < TELEMETRY_MAX_VALUES; i++) {
+            if (snapshot.names[i][0] == '\0') continue;
+            printf("%-32s %12llu\n", snapshot.names[i], static_cast<unsigned long long>(snapshot.values[i]));
+            if (graphName == snapshot.names[i]) {
+                history.push_back(snapshot.values[i]);
+                if (history.size() > historyLength) history.pop_front();
+            }
+        }
+
+        if (!history.empty()) {
+            uint64_t maximum = 1;
+            for (auto value: history) maximum = std::max(maximum, value);
+            printf("\n%s (max %llu)\n", graphName.c_str(), static_cast<unsigned long long>(maximum));
+            for (int row = 8; row > 0; row--) {
+                for (auto value: history) putchar(value * 8 >= maximum * row ? '#' : ' ');
+                putchar('\n');
+            }
+        }
+        fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+    }
+}